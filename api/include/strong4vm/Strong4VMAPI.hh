@@ -11,6 +11,7 @@
 #ifndef STRONG4VM_API_HH
 #define STRONG4VM_API_HH
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
@@ -40,7 +41,9 @@ enum class ConversionMode {
 enum class BackboneDetector {
     ONE,        ///< CheckCandidatesOneByOne with activity bumping (default, recommended)
     FLATLAND,   ///< FastOnCliffsSlowOnPlains adaptive cliff/plain strategy
-    RUSH        ///< RushAndPray detector (experimental)
+    RUSH,       ///< RushAndPray detector (experimental)
+    CHUNK,      ///< CheckCandidatesInChunks, groups of candidates narrowed by the unsat core
+    PORTFOLIO   ///< The three detectors raced on hard variables (up to 3 threads per worker)
 };
 
 /**
@@ -58,7 +61,20 @@ struct AnalysisConfig {
 
     // Graph generation settings
     BackboneDetector detector;        ///< Backbone detector algorithm (default: ONE)
-    int num_threads;                  ///< Number of threads for parallel processing (default: 1)
+    bool model_rotation;              ///< Refute candidates by flipping them in each model (default: false)
+    int num_threads;                  ///< Number of threads for parallel processing, 0 for all available CPUs (default: 1)
+    bool pin_threads;                 ///< Pin each worker thread to one CPU (default: false)
+    bool oversubscribe;               ///< Allow more threads than available CPUs (default: false)
+    bool write_atomic_sets;           ///< Write the atomic sets file (default: false)
+    bool write_binary_graphs;         ///< Also write the graphs in binary CSR format (default: false)
+    bool checkpoint;                  ///< Log finished variables to checkpoint files (default: false)
+    bool resume;                      ///< Resume from the checkpoint files of a previous run (default: false)
+    std::string report_file;          ///< Write the JSON run report to this file (default: empty, no report)
+    int64_t conflict_budget;          ///< Solver conflicts per variable, negative for no limit (default: -1)
+    std::string previous_version;     ///< Outputs of a previous version to reuse, without suffix (default: empty)
+    int shard_index;                  ///< Shard computed by this run, from 0 (default: 0)
+    int shard_count;                  ///< Number of shards, 1 for no sharding (default: 1)
+    bool merge_shards;                ///< Merge the shard files of the output directory (default: false)
 
     // Verbosity
     bool verbose;                     ///< Print progress messages (default: false)
@@ -73,7 +89,20 @@ struct AnalysisConfig {
         , conversion_mode(ConversionMode::STRAIGHTFORWARD)
         , keep_dimacs(false)
         , detector(BackboneDetector::ONE)
+        , model_rotation(false)
         , num_threads(1)
+        , pin_threads(false)
+        , oversubscribe(false)
+        , write_atomic_sets(false)
+        , write_binary_graphs(false)
+        , checkpoint(false)
+        , resume(false)
+        , report_file("")
+        , conflict_budget(-1)
+        , previous_version("")
+        , shard_index(0)
+        , shard_count(1)
+        , merge_shards(false)
         , verbose(false) {}
 };
 
@@ -102,12 +131,18 @@ struct AnalysisResult {
     std::vector<int> global_backbone; ///< Global backbone literals
     std::vector<int> core_features;   ///< Core features (always selected)
     std::vector<int> dead_features;   ///< Dead features (never selected)
+    int num_unknown_variables;        ///< Variables left incomplete by the conflict budget
+    int num_reused_variables;         ///< Variables whose edges were copied from the previous version
 
     // Output files
     std::string requires_graph_file;  ///< Path to requires graph (.net)
     std::string excludes_graph_file;  ///< Path to excludes graph (.net)
     std::string core_features_file;   ///< Path to core features (.txt)
     std::string dead_features_file;   ///< Path to dead features (.txt)
+    std::string atomic_sets_file;     ///< Path to atomic sets (.txt, if written)
+    std::string graphs_csr_file;      ///< Path to binary CSR graphs (.csr, if written)
+    std::string unknown_file;         ///< Path to the undecided edges (.txt, with a conflict budget)
+    std::string shard_file;           ///< Path to the shard rows (.log, shard runs only; no other outputs)
     std::string dimacs_file;          ///< Path to DIMACS file (if kept)
 
     /**
@@ -124,10 +159,16 @@ struct AnalysisResult {
         , num_variables(0)
         , num_clauses(0)
         , num_skipped_constraints(0)
+        , num_unknown_variables(0)
+        , num_reused_variables(0)
         , requires_graph_file("")
         , excludes_graph_file("")
         , core_features_file("")
         , dead_features_file("")
+        , atomic_sets_file("")
+        , graphs_csr_file("")
+        , unknown_file("")
+        , shard_file("")
         , dimacs_file("") {}
 };
 
@@ -187,8 +187,8 @@ public:
         }
 
         // Validate thread count
-        if (config.num_threads < 1) {
-            return "Thread count must be at least 1";
+        if (config.num_threads < 0) {
+            return "Thread count must be at least 1 (or 0 for all available CPUs)";
         }
 
         // Validate output directory if specified
@@ -218,6 +218,8 @@ public:
     std::string detector_to_string(BackboneDetector detector) const {
         if (detector == BackboneDetector::FLATLAND) return "flatland";
         if (detector == BackboneDetector::RUSH) return "rush";
+        if (detector == BackboneDetector::CHUNK) return "chunk";
+        if (detector == BackboneDetector::PORTFOLIO) return "portfolio";
         return "one";  // ONE is the default
     }
 
@@ -372,6 +374,18 @@ public:
 
         dimacs2graphs::Dimacs2GraphsAPI graph_api;
         graph_api.set_filter_auxiliary(true);
+        graph_api.set_write_atomic_sets(config.write_atomic_sets);
+        graph_api.set_binary_output(config.write_binary_graphs);
+        graph_api.set_checkpointing(config.checkpoint);
+        graph_api.set_resume(config.resume);
+        graph_api.set_report_file(config.report_file);
+        graph_api.set_conflict_budget(config.conflict_budget);
+        graph_api.set_model_rotation(config.model_rotation);
+        graph_api.set_previous_version(config.previous_version);
+        graph_api.set_shard(config.shard_index, config.shard_count);
+        graph_api.set_merge_shards(config.merge_shards);
+        graph_api.set_pin_threads(config.pin_threads);
+        graph_api.set_oversubscribe(config.oversubscribe);
 
         std::string detector_str = detector_to_string(config.detector);
         bool graph_success = graph_api.generate_graphs(
@@ -402,6 +416,8 @@ public:
 
         // Get global backbone
         result.global_backbone = graph_api.get_global_backbone();
+        result.num_unknown_variables = graph_api.get_num_unknown_variables();
+        result.num_reused_variables = graph_api.get_num_reused_variables();
 
         // Separate core and dead features from backbone
         for (int lit : result.global_backbone) {
@@ -412,11 +428,26 @@ public:
             }
         }
 
-        // Set output file paths
-        result.requires_graph_file = output_dir + "/" + basename + "__requires.net";
-        result.excludes_graph_file = output_dir + "/" + basename + "__excludes.net";
-        result.core_features_file = output_dir + "/" + basename + "__core.txt";
-        result.dead_features_file = output_dir + "/" + basename + "__dead.txt";
+        // Set output file paths (a shard run only writes its shard file)
+        if (config.shard_count > 1) {
+            result.shard_file = output_dir + "/" + basename + "__shard_" +
+                                std::to_string(config.shard_index) + "_of_" +
+                                std::to_string(config.shard_count) + ".log";
+        } else {
+            result.requires_graph_file = output_dir + "/" + basename + "__requires.net";
+            result.excludes_graph_file = output_dir + "/" + basename + "__excludes.net";
+            result.core_features_file = output_dir + "/" + basename + "__core.txt";
+            result.dead_features_file = output_dir + "/" + basename + "__dead.txt";
+            if (config.write_atomic_sets) {
+                result.atomic_sets_file = output_dir + "/" + basename + "__atomic_sets.txt";
+            }
+            if (config.write_binary_graphs) {
+                result.graphs_csr_file = output_dir + "/" + basename + "__graphs.csr";
+            }
+            if (config.conflict_budget >= 0) {
+                result.unknown_file = output_dir + "/" + basename + "__unknown.txt";
+            }
+        }
 
         if (verbose) {
             std::cout << "\nGraph generation successful!\n";
@@ -424,11 +455,30 @@ public:
             std::cout << "  Clauses:   " << result.num_clauses << "\n";
             std::cout << "  Core features: " << result.core_features.size() << "\n";
             std::cout << "  Dead features: " << result.dead_features.size() << "\n";
+            if (config.conflict_budget >= 0) {
+                std::cout << "  Incomplete variables: " << result.num_unknown_variables << "\n";
+            }
+            if (!config.previous_version.empty()) {
+                std::cout << "  Reused variables: " << result.num_reused_variables << "\n";
+            }
             std::cout << "\nOutput files:\n";
-            std::cout << "  " << result.requires_graph_file << "\n";
-            std::cout << "  " << result.excludes_graph_file << "\n";
-            std::cout << "  " << result.core_features_file << "\n";
-            std::cout << "  " << result.dead_features_file << "\n";
+            if (!result.shard_file.empty()) {
+                std::cout << "  " << result.shard_file << "\n";
+            } else {
+                std::cout << "  " << result.requires_graph_file << "\n";
+                std::cout << "  " << result.excludes_graph_file << "\n";
+                std::cout << "  " << result.core_features_file << "\n";
+                std::cout << "  " << result.dead_features_file << "\n";
+            }
+            if (!result.atomic_sets_file.empty()) {
+                std::cout << "  " << result.atomic_sets_file << "\n";
+            }
+            if (!result.graphs_csr_file.empty()) {
+                std::cout << "  " << result.graphs_csr_file << "\n";
+            }
+            if (!result.unknown_file.empty()) {
+                std::cout << "  " << result.unknown_file << "\n";
+            }
 
             if (verbose) {
                 std::cout << "\n=================================================\n";
@@ -10,6 +10,7 @@
  *
  * Usage:
  *   strong4vm <input_file> [options]
+ *   strong4vm merge <input_file> [options]
  */
 
 #include <iostream>
@@ -17,6 +18,9 @@
 #include <string>
 #include <filesystem>
 #include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
 #include "icon_embedded.hh"
 #include "../uvl2dimacs/api/include/uvl2dimacs/UVL2Dimacs.hh"
 #include "../dimacs2graphs/api/Dimacs2GraphsAPI.hh"
@@ -38,25 +42,56 @@ void print_header() {
 }
 
 void print_usage(const char* program_name) {
-    std::cout << "Usage: " << program_name << " <input_file> [options]\n\n";
+    std::cout << "Usage: " << program_name << " <input_file> [options]\n";
+    std::cout << "       " << program_name << " merge <input_file> [options]\n\n";
     std::cout << "Arguments:\n";
     std::cout << "  input_file           Input file (<basename>.uvl or <basename>.dimacs)\n\n";
+    std::cout << "Commands:\n";
+    std::cout << "  merge                Write the outputs from the shard files of the output\n";
+    std::cout << "                       directory (see -s), computing any missing variables\n\n";
     std::cout << "Options:\n";
-    std::cout << "  -t, --threads N      Number of threads for graph generation (default: 1)\n";
+    std::cout << "  -t, --threads N      Number of threads for graph generation (default: 1), or\n";
+    std::cout << "                       auto for all the CPUs available to the process\n";
+    std::cout << "                       (affinity mask and cgroup CPU quota); with -d portfolio\n";
+    std::cout << "                       each thread uses three CPUs\n";
+    std::cout << "      --pin            Pin each thread to its CPUs (Linux)\n";
+    std::cout << "      --oversubscribe  Allow more threads than available CPUs\n";
     std::cout << "  -o, --output DIR     Output directory (default: same as input file)\n";
+    std::cout << "  -d, --detector NAME  Backbone detector: one (default), flatland, rush, chunk,\n";
+    std::cout << "                       or portfolio (races the others on hard variables in\n";
+    std::cout << "                       two extra threads per thread, three CPUs in all)\n";
+    std::cout << "  -m, --rotate         Refute backbone candidates by flipping them in each model\n";
     std::cout << "  -k, --keep-dimacs    Keep intermediate DIMACS file (UVL input only)\n";
     std::cout << "  -e, --enable-tseitin Enable Tseitin transformation for UVL conversion\n";
+    std::cout << "  -a, --atomic-sets    Write the atomic sets (groups of equivalent features)\n";
+    std::cout << "  -b, --binary         Also write both graphs in binary CSR format\n";
+    std::cout << "  -c, --checkpoint     Checkpoint finished variables (for --resume after a crash)\n";
+    std::cout << "  -r, --resume         Resume an interrupted run from its checkpoints\n";
+    std::cout << "  -p, --report FILE    Write a JSON report of timings and solver work to FILE\n";
+    std::cout << "  -l, --limit N        Give up on a variable after N solver conflicts\n";
+    std::cout << "  -i, --incremental BASE\n";
+    std::cout << "                       Reuse the results of a previous version of the model\n";
+    std::cout << "                       (BASE.dimacs, kept with -k, and its BASE__* outputs)\n";
+    std::cout << "  -s, --shard I/N      Compute only shard I (0 to N-1) of N and write its edges\n";
+    std::cout << "                       to <basename>__shard_I_of_N.log (then run merge)\n";
     std::cout << "  -h, --help           Display this help message\n\n";
     std::cout << "Output Files:\n";
     std::cout << "  <basename>__requires.net   Dependency graph (Pajek format)\n";
     std::cout << "  <basename>__excludes.net   Conflict graph (Pajek format)\n";
     std::cout << "  <basename>__core.txt       Core features (enabled in all configurations)\n";
-    std::cout << "  <basename>__dead.txt       Dead features (disabled in all configurations)\n\n";
+    std::cout << "  <basename>__dead.txt       Dead features (disabled in all configurations)\n";
+    std::cout << "  <basename>__atomic_sets.txt Atomic sets (with -a only)\n";
+    std::cout << "  <basename>__graphs.csr     Both graphs, memory-mappable (with -b only)\n";
+    std::cout << "  <basename>__unknown.txt    Undecided edges (with -l only)\n\n";
     std::cout << "Examples:\n";
     std::cout << "  " << program_name << " model.uvl\n";
     std::cout << "  " << program_name << " model.uvl -t 4\n";
     std::cout << "  " << program_name << " model.dimacs -t 8\n";
-    std::cout << "  " << program_name << " model.uvl -o ./output -k\n\n";
+    std::cout << "  " << program_name << " model.uvl -o ./output -k\n";
+    std::cout << "  " << program_name << " model.dimacs -t 8 -c    (after a crash: add -r)\n";
+    std::cout << "  " << program_name << " model_v2.uvl -k -i model_v1\n";
+    std::cout << "  " << program_name << " model.dimacs -s 0/2 & " << program_name
+              << " model.dimacs -s 1/2; " << program_name << " merge model.dimacs\n\n";
     std::cout << "You may find UVL models in:\n";
     std::cout << "  - the directory \"examples\" of this tool\n";
     std::cout << "  - https://www.uvlhub.io/\n";
@@ -114,22 +149,84 @@ int main(int argc, char* argv[]) {
     int num_threads = 1;
     bool keep_dimacs = false;
     bool use_tseitin = false;
+    bool write_atomic_sets = false;
+    bool write_binary_graphs = false;
+    bool checkpoint = false;
+    bool resume = false;
+    std::string report_file;
+    std::string detector = "one";
+    long long conflict_budget = -1;
+    bool model_rotation = false;
+    std::string previous_version;
+    int shard_index = 0;
+    int shard_count = 1;
+    bool merge_shards = false;
+    bool pin_threads = false;
+    bool oversubscribe = false;
 
     // Parse arguments
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
 
-        if (arg == "-h" || arg == "--help") {
+        if (i == 1 && arg == "merge") {
+            merge_shards = true;
+        } else if (arg == "-h" || arg == "--help") {
             print_usage(argv[0]);
             return 0;
         } else if (arg == "-k" || arg == "--keep-dimacs") {
             keep_dimacs = true;
         } else if (arg == "-e" || arg == "--enable-tseitin") {
             use_tseitin = true;
+        } else if (arg == "-a" || arg == "--atomic-sets") {
+            write_atomic_sets = true;
+        } else if (arg == "-b" || arg == "--binary") {
+            write_binary_graphs = true;
+        } else if (arg == "-c" || arg == "--checkpoint") {
+            checkpoint = true;
+        } else if (arg == "-r" || arg == "--resume") {
+            resume = true;
+        } else if (arg == "--pin") {
+            pin_threads = true;
+        } else if (arg == "--oversubscribe") {
+            oversubscribe = true;
+        } else if (arg == "-m" || arg == "--rotate") {
+            model_rotation = true;
         } else if ((arg == "-t" || arg == "--threads") && i + 1 < argc) {
-            num_threads = std::atoi(argv[++i]);
-            if (num_threads < 1) {
-                std::cerr << "Error: Thread count must be at least 1\n";
+            const std::string threads = argv[++i];
+            num_threads = threads == "auto" ? 0 : std::atoi(threads.c_str());
+            if (num_threads < 1 && threads != "auto") {
+                std::cerr << "Error: Thread count must be at least 1 (or auto)\n";
+                return 1;
+            }
+        } else if ((arg == "-l" || arg == "--limit") && i + 1 < argc) {
+            const char* limit = argv[++i];
+            char* end = nullptr;
+            errno = 0;
+            conflict_budget = std::strtoll(limit, &end, 10);
+            if (end == limit || *end != '\0' || errno == ERANGE) {
+                std::cerr << "Error: Conflict limit must be a number, got '" << limit << "'\n";
+                return 1;
+            }
+            if (conflict_budget < 0) {
+                std::cerr << "Error: Conflict limit must not be negative\n";
+                return 1;
+            }
+        } else if ((arg == "-s" || arg == "--shard") && i + 1 < argc) {
+            char slash = 0;
+            if (std::sscanf(argv[++i], "%d%c%d", &shard_index, &slash, &shard_count) != 3 ||
+                slash != '/' || shard_count < 1 || shard_index < 0 || shard_index >= shard_count) {
+                std::cerr << "Error: Shard must be I/N with 0 <= I < N\n";
+                return 1;
+            }
+        } else if ((arg == "-i" || arg == "--incremental") && i + 1 < argc) {
+            previous_version = argv[++i];
+        } else if ((arg == "-p" || arg == "--report") && i + 1 < argc) {
+            report_file = argv[++i];
+        } else if ((arg == "-d" || arg == "--detector") && i + 1 < argc) {
+            detector = argv[++i];
+            if (detector != "one" && detector != "flatland" && detector != "rush" &&
+                detector != "chunk" && detector != "portfolio") {
+                std::cerr << "Error: Unknown detector: " << detector << "\n";
                 return 1;
             }
         } else if ((arg == "-o" || arg == "--output") && i + 1 < argc) {
@@ -242,13 +339,24 @@ int main(int argc, char* argv[]) {
 
     // Always filter auxiliary variables (aux_* and k!\d+ Tseitin vars) from output
     graph_api.set_filter_auxiliary(true);
+    graph_api.set_write_atomic_sets(write_atomic_sets);
+    graph_api.set_binary_output(write_binary_graphs);
+    graph_api.set_checkpointing(checkpoint);
+    graph_api.set_resume(resume);
+    graph_api.set_report_file(report_file);
+    graph_api.set_conflict_budget(conflict_budget);
+    graph_api.set_model_rotation(model_rotation);
+    graph_api.set_previous_version(previous_version);
+    graph_api.set_shard(shard_index, shard_count);
+    graph_api.set_merge_shards(merge_shards);
+    graph_api.set_pin_threads(pin_threads);
+    graph_api.set_oversubscribe(oversubscribe);
 
     // Use the basename without path for graph generation
     std::string dimacs_basename = get_basename(dimacs_file);
 
     // The API expects output_dir as a directory path, not including basename
-    // Always use "one" detector (with activity bumping)
-    bool success = graph_api.generate_graphs(dimacs_file, output_dir, "one", num_threads);
+    bool success = graph_api.generate_graphs(dimacs_file, output_dir, detector, num_threads);
 
     if (!success) {
         std::cerr << "\nError: Graph generation failed\n";
@@ -265,11 +373,31 @@ int main(int argc, char* argv[]) {
     std::cout << "\nGraph generation successful!\n";
     std::cout << "  Variables: " << graph_api.get_num_variables() << "\n";
     std::cout << "  Clauses:   " << graph_api.get_num_clauses() << "\n";
+    if (conflict_budget >= 0) {
+        std::cout << "  Incomplete variables: " << graph_api.get_num_unknown_variables() << "\n";
+    }
+    if (!previous_version.empty()) {
+        std::cout << "  Reused variables: " << graph_api.get_num_reused_variables() << "\n";
+    }
     std::cout << "\nOutput files:\n";
-    std::cout << "  " << output_dir << "/" << dimacs_basename << "__requires.net\n";
-    std::cout << "  " << output_dir << "/" << dimacs_basename << "__excludes.net\n";
-    std::cout << "  " << output_dir << "/" << dimacs_basename << "__core.txt\n";
-    std::cout << "  " << output_dir << "/" << dimacs_basename << "__dead.txt\n";
+    if (shard_count > 1) {
+        std::cout << "  " << output_dir << "/" << dimacs_basename << "__shard_" << shard_index
+                  << "_of_" << shard_count << ".log\n";
+    } else {
+        std::cout << "  " << output_dir << "/" << dimacs_basename << "__requires.net\n";
+        std::cout << "  " << output_dir << "/" << dimacs_basename << "__excludes.net\n";
+        std::cout << "  " << output_dir << "/" << dimacs_basename << "__core.txt\n";
+        std::cout << "  " << output_dir << "/" << dimacs_basename << "__dead.txt\n";
+        if (write_atomic_sets) {
+            std::cout << "  " << output_dir << "/" << dimacs_basename << "__atomic_sets.txt\n";
+        }
+        if (write_binary_graphs) {
+            std::cout << "  " << output_dir << "/" << dimacs_basename << "__graphs.csr\n";
+        }
+        if (conflict_budget >= 0) {
+            std::cout << "  " << output_dir << "/" << dimacs_basename << "__unknown.txt\n";
+        }
+    }
 
     // Clean up temporary DIMACS file if needed
     if (temp_dimacs && fs::exists(dimacs_file)) {
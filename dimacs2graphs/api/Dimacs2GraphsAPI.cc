@@ -19,38 +19,48 @@
  *   - Compute backbone assuming v=true
  *   - Extract requires edges: if assuming v forces i (and i is not core), then v requires i
  *   - Extract excludes edges: if assuming v forbids i (and neither v nor i are dead), then v excludes i
- * - Uses multi-threaded processing with range-based static work partitioning
- * - Each thread processes an independent subset of variables
+ * - Equivalent variables (atomic sets) share one backbone computation; their edges
+ *   are expanded back out per variable
+ * - Variables are processed bottom-up along the binary implication graph, so the
+ *   backbones of implied variables can be reused (transitive scheduling)
+ * - Uses multi-threaded processing with a dynamic job queue: threads claim chunks
+ *   of the schedule that shrink as it drains, and the main thread works too
  *
  * **Phase 3: Output Generation**
  * - Generates Pajek .net format graph files:
  *   - `[basename]__requires.net`: Directed graph (v -> i means selecting v requires i)
  *   - `[basename]__excludes.net`: Undirected graph (v -- i means mutual exclusion)
+ * - Optionally writes both graphs in a binary CSR file (`[basename]__graphs.csr`)
+ *   that can be memory-mapped with GraphCSR
  * - Generates feature list files:
  *   - `[basename]__core.txt`: Positive backbone features (always selected)
  *   - `[basename]__dead.txt`: Negative backbone features (never selected)
+ *   - `[basename]__atomic_sets.txt`: Atomic sets with more than one variable (optional)
  *
  * **Threading Architecture (CRITICAL)**
  *
- * The implementation uses a pre-initialization pattern to ensure thread safety:
- * 1. Main thread creates and initializes all BoneDiggerAPI instances sequentially
- * 2. Each thread receives a pre-initialized solver instance (no initialization in worker threads)
- * 3. Worker threads only perform variable processing using their assigned solver
- * 4. Results are collected in thread-local buffers and merged in the main thread
+ * 1. The main thread parses the DIMACS file once (its own BoneDiggerAPI instance)
+ * 2. Each extra thread builds its own BoneDiggerAPI instance concurrently, sharing
+ *    the immutable clause store of the main instance (BoneDiggerAPI::share_formula())
+ * 3. All threads, the main one included, process variables with their own solver
+ * 4. Edge targets are kept in packed per-worker rows (uint32) and formatted in output
+ *    order by the main thread while writing the files
+ * 5. Optionally, each worker also appends its finished rows to its own checkpoint
+ *    log, so that an interrupted run can be resumed without redoing them
  *
- * This pattern is required because BoneDiggerAPI is NOT thread-safe during initialization.
- * Violating this pattern (e.g., creating solvers inside worker threads) will cause data races
- * and undefined behavior.
+ * BoneDiggerAPI instances have no shared mutable state, so they can be built in
+ * parallel; an instance must never be used by two threads at once.
  *
  * **Performance Characteristics**
- * - Thread count limited to CPU cores (fail-fast validation)
+ * - Thread count limited to the CPUs the process may use: affinity mask and
+ *   cgroup CPU quota (fail-fast validation, unless oversubscription is allowed)
  * - Memory requirement: approximately 60-70 MB per thread
- * - Static work partitioning ensures balanced load distribution
+ * - Dynamic work distribution keeps all threads busy despite skewed per-variable cost
  * - Progress monitoring with atomic counters (low overhead)
  *
  * @warning BoneDiggerAPI is NOT thread-safe. Each thread must use a separate solver
- *          instance, and all instances must be created and initialized in the main thread
- *          BEFORE spawning worker threads.
+ *          instance. Instances may share a formula through share_formula(), which must
+ *          not run while the source instance reads a new file.
  *
  * @see Dimacs2GraphsAPI.hh for the public API interface
  * @see BoneDiggerAPI for the underlying SAT-based backbone detection
@@ -60,6 +70,7 @@
  */
 
 #include "Dimacs2GraphsAPI.hh"
+#include "GraphCSR.hh"
 #include "../../uvl2dimacs/backbone_solver/src/api/BoneDiggerAPI.hh"
 #include <stdlib.h>
 #include <string.h>
@@ -72,10 +83,25 @@
 #include <algorithm>
 #include <thread>
 #include <atomic>
-#include <chrono>
 #include <mutex>
 #include <memory>
 #include <filesystem>
+#include <shared_mutex>
+#include <unordered_set>
+#include <unordered_map>
+#include <cstdint>
+#include <charconv>
+#include <iomanip>
+#include <cstdio>
+#include <chrono>
+#include <cerrno>
+#include <cmath>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 using namespace std;
 using namespace dimacs2graphs;
@@ -95,20 +121,47 @@ using namespace bonedigger;
  * - BoneDiggerAPI instance for SAT-based backbone detection
  * - Formula statistics (number of variables and clauses)
  * - Global backbone vector (core and dead features)
+ * - Shared model cache used to pre-filter backbone candidates
  * - File path utilities (basename extraction, directory handling, path normalization)
  * - Thread coordination structures and worker management
  * - Error message storage for diagnostic reporting
  */
 class Dimacs2GraphsAPI::Impl {
 public:
+    struct ModelStore;
+
     BoneDiggerAPI bone_api;
     int num_variables;
     int num_clauses;
     vector<int> global_backbone;
     string error_message;
     bool filter_auxiliary;
-
-    Impl() : num_variables(0), num_clauses(0), filter_auxiliary(false) {}
+    int model_cache_size;
+    bool transitive_scheduling;
+    bool atomic_sets;
+    bool write_atomic_sets;
+    bool binary_output;
+    bool checkpointing;
+    bool resume;
+    string report_file;
+    int64_t conflict_budget;
+    bool model_rotation;
+    int unknown_variables;
+    string previous_version;
+    int reused_variables;
+    int shard_index;
+    int shard_count;
+    bool merge_shards;
+    bool pin_threads;
+    bool oversubscribe;
+    unique_ptr<ModelStore> model_store;
+
+    Impl() : num_variables(0), num_clauses(0), filter_auxiliary(false), model_cache_size(2048),
+             transitive_scheduling(true), atomic_sets(true), write_atomic_sets(false),
+             binary_output(false), checkpointing(false), resume(false), conflict_budget(-1),
+             model_rotation(false),
+             unknown_variables(0), reused_variables(0), shard_index(0), shard_count(1),
+             merge_shards(false), pin_threads(false), oversubscribe(false) {}
 
     /**
      * @brief Normalizes a file path by removing trailing slashes
@@ -273,92 +326,817 @@ public:
         return true;
     }
 
+    /**
+     * @brief Groups equivalent variables into atomic sets
+     *
+     * Two variables are equivalent when their positive literals lie in the same
+     * strongly connected component of the binary implication graph, i.e. each
+     * one implies the other through a chain of binary clauses (mandatory
+     * relations produce such parent <=> child pairs). Equivalent variables have
+     * the same backbone, so it only has to be computed for one of them.
+     *
+     * Iterative Tarjan SCC over the 2 * (num_vars + 1) literal nodes; literal
+     * +x is node 2x and -x is node 2x + 1.
+     *
+     * @param num_vars Number of variables in the formula
+     * @param binaries Binary clauses of the formula (DIMACS literals)
+     * @param vars Variables that will be processed, in ascending order
+     * @param representative Output: for each variable in vars, the first variable
+     *                       of vars in its atomic set (itself if alone)
+     */
+    void find_atomic_sets(int num_vars, const vector<pair<int, int>>& binaries,
+                          const vector<int>& vars, vector<int>& representative) {
+        const int n = 2 * (num_vars + 1);
+        auto node = [](int lit) { return lit > 0 ? 2 * lit : 2 * -lit + 1; };
+
+        // (a b) means -a -> b and -b -> a, stored in CSR form
+        vector<int> first(n + 1, 0), targets(2 * binaries.size());
+        for (const auto& clause : binaries) {
+            first[node(-clause.first) + 1]++;
+            first[node(-clause.second) + 1]++;
+        }
+        for (int x = 0; x < n; x++) first[x + 1] += first[x];
+        vector<int> fill(first.begin(), first.end() - 1);
+        for (const auto& clause : binaries) {
+            targets[fill[node(-clause.first)]++] = node(clause.second);
+            targets[fill[node(-clause.second)]++] = node(clause.first);
+        }
+
+        vector<int> index(n, -1), low(n, 0), component(n, -1), tarjan_stack;
+        vector<pair<int, int>> call_stack;
+        int counter = 0, components = 0;
+        for (int root : vars) {
+            if (index[2 * root] >= 0) continue;
+            call_stack.emplace_back(2 * root, first[2 * root]);
+            index[2 * root] = low[2 * root] = counter++;
+            tarjan_stack.push_back(2 * root);
+
+            while (!call_stack.empty()) {
+                const int x = call_stack.back().first;
+                int& next = call_stack.back().second;
+                if (next < first[x + 1]) {
+                    const int y = targets[next++];
+                    if (index[y] < 0) {
+                        index[y] = low[y] = counter++;
+                        tarjan_stack.push_back(y);
+                        call_stack.emplace_back(y, first[y]);
+                    } else if (component[y] < 0) {
+                        low[x] = min(low[x], index[y]);
+                    }
+                    continue;
+                }
+                call_stack.pop_back();
+                if (!call_stack.empty()) {
+                    const int parent = call_stack.back().first;
+                    low[parent] = min(low[parent], low[x]);
+                }
+                if (low[x] == index[x]) {
+                    int y;
+                    do {
+                        y = tarjan_stack.back();
+                        tarjan_stack.pop_back();
+                        component[y] = components;
+                    } while (y != x);
+                    components++;
+                }
+            }
+        }
+
+        vector<int> leader(components, 0);
+        for (int v : vars) {
+            int& first_var = leader[component[2 * v]];
+            if (first_var == 0) first_var = v;
+            representative[v] = first_var;
+        }
+    }
+
+    /**
+     * @struct ModelStore
+     * @brief Shared cache of the satisfying assignments found so far
+     *
+     * Every model found while processing any variable is a witness for the
+     * other variables too: a model where u is true and i is false proves that
+     * u does not require i, and a model where u and i are both true proves
+     * that u does not exclude i. Before the backbone under u=true is computed,
+     * the literals refuted by the stored models with u true are handed to the
+     * detector, which drops them from its candidates without a SAT call.
+     *
+     * Models are bit-packed (one bit per variable), deduplicated by hash and
+     * kept up to a fixed capacity; later models are ignored. A hash collision
+     * only means that a model is not cached, never that an edge is lost.
+     *
+     * Thread safety: add() takes the lock exclusively and refuted_literals()
+     * shares it, so all workers can feed and query the same store.
+     */
+    struct ModelStore {
+        int num_variables;
+        size_t words_per_model;
+        size_t max_models;
+        size_t num_models;
+        vector<uint64_t> bits;
+        unordered_set<uint64_t> hashes;
+        shared_mutex lock;
+
+        /**
+         * @param num_vars Number of variables in the formula
+         * @param capacity Maximum number of models kept
+         */
+        ModelStore(int num_vars, size_t capacity)
+            : num_variables(num_vars),
+              words_per_model(static_cast<size_t>(num_vars) / 64 + 1),
+              max_models(capacity), num_models(0) {}
+
+        /**
+         * @brief Stores a model unless it is already known or the store is full
+         *
+         * @param model model[v] is true if variable v is true
+         */
+        void add(const vector<bool>& model) {
+            vector<uint64_t> packed(words_per_model, 0);
+            const int limit = min(num_variables + 1, static_cast<int>(model.size()));
+            for (int v = 1; v < limit; v++) {
+                if (model[v]) packed[v >> 6] |= uint64_t(1) << (v & 63);
+            }
+
+            // FNV-1a over the packed words
+            uint64_t hash = 14695981039346656037ULL;
+            for (uint64_t word : packed) {
+                hash = (hash ^ word) * 1099511628211ULL;
+            }
+
+            unique_lock<shared_mutex> guard(lock);
+            if (num_models >= max_models || !hashes.insert(hash).second) return;
+            bits.insert(bits.end(), packed.begin(), packed.end());
+            num_models++;
+        }
+
+        /**
+         * @brief Collects the literals refuted by the stored models with v true
+         *
+         * @param v Variable assumed to be true
+         * @param seen_true Scratch buffer (variables true in some model)
+         * @param seen_false Scratch buffer (variables false in some model)
+         * @param refuted Output: literals that cannot be in the backbone under v
+         */
+        void refuted_literals(int v, vector<uint64_t>& seen_true,
+                              vector<uint64_t>& seen_false,
+                              vector<int>& refuted) {
+            refuted.clear();
+            seen_true.assign(words_per_model, 0);
+            seen_false.assign(words_per_model, 0);
+
+            const size_t v_word = static_cast<size_t>(v) >> 6;
+            const uint64_t v_mask = uint64_t(1) << (v & 63);
+            bool found = false;
+            {
+                shared_lock<shared_mutex> guard(lock);
+                for (size_t m = 0; m < num_models; m++) {
+                    const uint64_t* row = &bits[m * words_per_model];
+                    if (!(row[v_word] & v_mask)) continue;
+                    found = true;
+                    for (size_t w = 0; w < words_per_model; w++) {
+                        seen_true[w] |= row[w];
+                        seen_false[w] |= ~row[w];
+                    }
+                }
+            }
+            if (!found) return;
+
+            for (int i = 1; i <= num_variables; i++) {
+                const uint64_t mask = uint64_t(1) << (i & 63);
+                if (seen_true[i >> 6] & mask) refuted.push_back(-i);
+                if (seen_false[i >> 6] & mask) refuted.push_back(i);
+            }
+        }
+    };
+
+    /**
+     * @struct TransitiveSchedule
+     * @brief Bottom-up processing order that reuses the backbones of successors
+     *
+     * Strong requires edges are transitive: if v implies w, everything in the
+     * backbone under w=true is also in the backbone under v=true. The binary
+     * clauses (-v w) of the formula give such direct implications (for formulas
+     * generated from UVL they include every child-to-parent edge of the feature
+     * tree). Variables are processed in reverse topological order of this
+     * implication graph, so most successors of v are finished before v; their
+     * backbones and the global backbone are handed to the detector as confirmed
+     * literals and need no UNSAT proof.
+     *
+     * The backbone of w is kept only until all variables implying w are done.
+     * Successors still in progress in another thread are simply skipped, so
+     * workers never wait for each other.
+     */
+    struct TransitiveSchedule {
+        vector<vector<int>> successors;  // Direct positive implications v -> w
+        vector<int> pending;             // Unprocessed variables implying each variable
+        vector<vector<int>> backbones;   // Backbone under w=true while pending[w] > 0
+        vector<char> done;
+        mutex lock;
+
+        /**
+         * @param num_vars Number of variables in the formula
+         * @param binaries Binary clauses of the formula (DIMACS literals)
+         * @param vars Variables that will be processed
+         * @param representative Atomic set representative of each variable
+         *                       (the variable itself outside of vars)
+         */
+        TransitiveSchedule(int num_vars, const vector<pair<int, int>>& binaries,
+                           const vector<int>& vars, const vector<int>& representative)
+            : successors(num_vars + 1), pending(num_vars + 1, 0),
+              backbones(num_vars + 1), done(num_vars + 1, 0) {
+            vector<char> processed(num_vars + 1, 0);
+            for (int v : vars) processed[v] = 1;
+
+            // (a b) means -a -> b and -b -> a; keep implications between
+            // positive literals of processed variables, lifted to representatives
+            auto link = [&](int from, int to) {
+                from = representative[from];
+                to = representative[to];
+                if (from != to && processed[from] && processed[to]) {
+                    successors[from].push_back(to);
+                }
+            };
+            for (const auto& clause : binaries) {
+                const int a = clause.first;
+                const int b = clause.second;
+                if (a < 0 && b > 0) {
+                    link(-a, b);
+                } else if (b < 0 && a > 0) {
+                    link(-b, a);
+                }
+            }
+            for (auto& next : successors) {
+                sort(next.begin(), next.end());
+                next.erase(unique(next.begin(), next.end()), next.end());
+                for (int w : next) pending[w]++;
+            }
+        }
+
+        /**
+         * @brief Orders the variables so that successors come first
+         *
+         * Iterative Tarjan SCC: components are completed sinks first, which is
+         * a reverse topological order of the implication graph.
+         *
+         * @param vars Variables to reorder (in place)
+         */
+        void order(vector<int>& vars) const {
+            const int n = static_cast<int>(successors.size());
+            vector<int> index(n, -1), low(n, 0), tarjan_stack, result;
+            vector<char> on_stack(n, 0);
+            vector<pair<int, size_t>> call_stack;
+            int counter = 0;
+            result.reserve(vars.size());
+
+            for (int root : vars) {
+                if (index[root] >= 0) continue;
+                call_stack.emplace_back(root, 0);
+                index[root] = low[root] = counter++;
+                tarjan_stack.push_back(root);
+                on_stack[root] = 1;
+
+                while (!call_stack.empty()) {
+                    const int v = call_stack.back().first;
+                    size_t& next = call_stack.back().second;
+                    if (next < successors[v].size()) {
+                        const int w = successors[v][next++];
+                        if (index[w] < 0) {
+                            index[w] = low[w] = counter++;
+                            tarjan_stack.push_back(w);
+                            on_stack[w] = 1;
+                            call_stack.emplace_back(w, 0);
+                        } else if (on_stack[w]) {
+                            low[v] = min(low[v], index[w]);
+                        }
+                        continue;
+                    }
+                    call_stack.pop_back();
+                    if (!call_stack.empty()) {
+                        const int parent = call_stack.back().first;
+                        low[parent] = min(low[parent], low[v]);
+                    }
+                    if (low[v] == index[v]) {
+                        int w;
+                        do {
+                            w = tarjan_stack.back();
+                            tarjan_stack.pop_back();
+                            on_stack[w] = 0;
+                            result.push_back(w);
+                        } while (w != v);
+                    }
+                }
+            }
+            vars.swap(result);
+        }
+
+        /**
+         * @brief Collects the literals known to be in the backbone under v=true
+         *
+         * @param v Variable about to be processed
+         * @param global_literals Global backbone literals
+         * @param mark Scratch buffer indexed by literal, used to skip duplicates
+         * @param confirmed Output: finished successors, their backbones and the
+         *                  global backbone
+         */
+        void confirmed_literals(int v, const vector<int>& global_literals,
+                                vector<int>& mark, vector<int>& confirmed) {
+            confirmed.clear();
+            vector<int> finished;
+            {
+                lock_guard<mutex> guard(lock);
+                for (int w : successors[v]) {
+                    if (done[w]) finished.push_back(w);
+                }
+            }
+
+            // backbones[w] cannot be released while v is pending, and done[w]
+            // was published under the lock, so it is safe to read it here
+            auto add = [&](int lit) {
+                const size_t slot = lit > 0 ? 2 * static_cast<size_t>(lit)
+                                            : 2 * static_cast<size_t>(-lit) + 1;
+                if (mark[slot] == v) return;
+                mark[slot] = v;
+                confirmed.push_back(lit);
+            };
+            for (int lit : global_literals) add(lit);
+            for (int w : finished) {
+                add(w);
+                for (int lit : backbones[w]) add(lit);
+            }
+        }
+
+        /**
+         * @brief Records the backbone under v=true for the variables implying v
+         *
+         * @param v Variable just processed
+         * @param backbone Its backbone (empty if v cannot be selected)
+         */
+        void publish(int v, const vector<int>& backbone) {
+            lock_guard<mutex> guard(lock);
+            if (pending[v] > 0) backbones[v] = backbone;
+            done[v] = 1;
+            for (int w : successors[v]) {
+                if (--pending[w] == 0) vector<int>().swap(backbones[w]);
+            }
+        }
+    };
+
+    /**
+     * @struct JobQueue
+     * @brief Dynamic distribution of the schedule among the workers
+     *
+     * Per-variable cost is very skewed, so fixed ranges leave threads idle while
+     * one is still busy. Workers instead claim consecutive chunks of the schedule
+     * from a shared atomic index. Chunks are guided: each one takes a fixed share
+     * of what is left, so they are large at the start (little contention) and
+     * shrink to single variables at the end (short tail). Claiming keeps the
+     * schedule order, which preserves most of the transitive reuse.
+     */
+    struct JobQueue {
+        atomic<int> next;
+        int total;
+        int num_workers;
+
+        /**
+         * @param jobs Number of entries in the schedule
+         * @param workers Number of workers pulling from the queue
+         */
+        JobQueue(int jobs, int workers) : next(0), total(jobs), num_workers(workers) {}
+
+        /**
+         * @brief Claims the next chunk of the schedule
+         *
+         * @param begin Output: first index of the chunk (inclusive)
+         * @param end Output: last index of the chunk (exclusive)
+         * @return false when the schedule is exhausted
+         */
+        bool claim(int& begin, int& end) {
+            int current = next.load();
+            while (current < total) {
+                const int chunk = max(1, (total - current) / (4 * num_workers));
+                if (next.compare_exchange_weak(current, current + chunk)) {
+                    begin = current;
+                    end = current + chunk;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Stops handing out work (after a worker failed)
+         */
+        void cancel() {
+            next = total;
+        }
+    };
+
+    /**
+     * @struct EdgeRow
+     * @brief Location of the edges of one variable
+     *
+     * Workers append the targets of the edges they find to their own packed
+     * uint32 buffers (one CSR-like row per variable, the source being implied
+     * by the row). Rows are not copied when the results are merged: the output
+     * is formatted directly from the worker buffers at write time.
+     */
+    struct EdgeRow {
+        int worker;                // Worker holding the row
+        uint32_t num_requires;     // Number of requires targets
+        uint32_t num_excludes;     // Number of excludes targets
+        size_t requires_begin;     // Offset in the worker's requires_edges
+        size_t excludes_begin;     // Offset in the worker's excludes_edges
+    };
+
+    /**
+     * @struct VariableReport
+     * @brief Cost of one scheduled variable (instrumented runs only)
+     */
+    struct VariableReport {
+        int position;                    // Position in vars_to_process
+        int worker;                      // Worker that processed it
+        double seconds;                  // Backbone query and edge extraction
+        size_t backbone_size;            // Backbone literals under v=true
+        size_t unknown;                  // Literals left undecided by the conflict budget
+        BoneDiggerAPI::QueryStats stats; // Detector work of the query
+    };
+
+    /**
+     * @struct PhaseTimes
+     * @brief Wall time of the phases of one graph generation, in seconds
+     */
+    struct PhaseTimes {
+        double parse = 0;            // Formula, detector and feature names
+        double global_backbone = 0;  // Core and dead features
+        double schedule = 0;         // Atomic sets, processing order, checkpoints
+        double variable_loop = 0;    // Per-variable backbones (all threads)
+        double merge = 0;            // Join, error checks, vertex names
+        double write = 0;            // Output files
+    };
+
+    /**
+     * @struct CheckpointHeader
+     * @brief First bytes of every checkpoint log
+     *
+     * Identifies the run the log belongs to: edges only depend on the formula
+     * and on auxiliary filtering, so logs are reusable when these match.
+     */
+    struct CheckpointHeader {
+        char magic[8];          // "S4VMCKP\0"
+        uint32_t version;
+        uint32_t num_variables;
+        uint32_t num_clauses;
+        uint32_t flags;         // Bit 0: auxiliary variables filtered
+        uint64_t formula_hash;  // FNV-1a of the DIMACS file
+    };
+
+    /**
+     * @struct CheckpointLog
+     * @brief Append-only log of the variables finished by one worker
+     *
+     * One record is appended per scheduled variable, holding the edge rows of
+     * every member of its atomic set:
+     *
+     *     [words][checksum][num_members] { [var][num_requires][num_excludes][targets...] }*
+     *
+     * where words counts the uint32 values after the checksum. Records are
+     * buffered and written with an fsync at most every CHECKPOINT_INTERVAL, so
+     * a crash loses at most that much work; a torn last record fails its
+     * checksum and is discarded on resume.
+     */
+    struct CheckpointLog {
+        static constexpr chrono::seconds CHECKPOINT_INTERVAL{1};
+        static constexpr size_t BUFFER_WORDS = 1 << 16;
+
+        int fd;
+        string path;
+        vector<uint32_t> buffer;
+        chrono::steady_clock::time_point last_sync;
+
+        CheckpointLog() : fd(-1) {}
+        ~CheckpointLog() {
+            if (fd >= 0) {
+                flush();
+                ::close(fd);
+            }
+        }
+
+        static uint32_t checksum(const uint32_t* words, size_t count) {
+            uint32_t hash = 2166136261u;
+            for (size_t i = 0; i < count; i++) {
+                hash = (hash ^ words[i]) * 16777619u;
+            }
+            return hash;
+        }
+
+        /**
+         * @brief Opens the log, either fresh or continuing a resumed one
+         *
+         * @param log_path Log file path
+         * @param header Header of the current run
+         * @param keep Valid prefix of an existing log to continue after
+         *             (0 to start a new log)
+         * @return false if the file cannot be created
+         */
+        bool open(const string& log_path, const CheckpointHeader& header, uint64_t keep) {
+            path = log_path;
+            fd = ::open(path.c_str(), O_WRONLY | O_CREAT | (keep == 0 ? O_TRUNC : 0), 0644);
+            if (fd < 0) return false;
+            if (keep > 0) {
+                if (ftruncate(fd, static_cast<off_t>(keep)) != 0 ||
+                    lseek(fd, 0, SEEK_END) < 0) {
+                    return false;
+                }
+            } else if (!write_all(reinterpret_cast<const char*>(&header), sizeof(header))) {
+                return false;
+            }
+            last_sync = chrono::steady_clock::now();
+            return true;
+        }
+
+        /**
+         * @brief Appends one record (payload without the words/checksum prefix)
+         * @return false on a write error
+         */
+        bool append(const vector<uint32_t>& payload) {
+            buffer.push_back(static_cast<uint32_t>(payload.size()));
+            buffer.push_back(checksum(payload.data(), payload.size()));
+            buffer.insert(buffer.end(), payload.begin(), payload.end());
+            if (buffer.size() >= BUFFER_WORDS ||
+                chrono::steady_clock::now() - last_sync >= CHECKPOINT_INTERVAL) {
+                return flush();
+            }
+            return true;
+        }
+
+        /**
+         * @brief Writes the buffered records and syncs them to disk
+         */
+        bool flush() {
+            bool ok = write_all(reinterpret_cast<const char*>(buffer.data()),
+                                buffer.size() * sizeof(uint32_t)) && fsync(fd) == 0;
+            buffer.clear();
+            last_sync = chrono::steady_clock::now();
+            return ok;
+        }
+
+        bool write_all(const char* data, size_t size) {
+            while (size > 0) {
+                ssize_t written = ::write(fd, data, size);
+                if (written < 0) {
+                    if (errno == EINTR) continue;
+                    return false;
+                }
+                data += written;
+                size -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+    };
+
+    /**
+     * @struct PreviousVersion
+     * @brief Results of a previous version of the model, in the current numbering
+     *
+     * Built by load_previous_version(). The old edges of a variable v are kept
+     * as literals sorted by variable: requires targets w as w, excludes
+     * neighbours w (in both directions) as -w. Together with the old core and
+     * dead features they give the old backbone under v=true, restricted to the
+     * variables listed in the old graphs (known ones).
+     */
+    struct PreviousVersion {
+        enum Hints {
+            NO_HINTS,       // Clauses added and removed: old backbones prove nothing
+            CONFIRM_OLD,    // Only added: the old backbone still holds
+            REFUTE_OTHERS   // Only removed: literals outside the old backbone do not hold
+        };
+
+        Hints hints = NO_HINTS;
+        size_t added = 0;          // Clauses of the current version only
+        size_t removed = 0;        // Clauses of the previous version only
+        vector<char> known;        // Per variable: matched and listed in the old graphs
+        vector<char> reusable;     // Per variable: its old edges are still exact
+        vector<int> old_value;     // Per variable: +1 old core, -1 old dead, 0 otherwise
+        vector<size_t> first;      // Old edges of v: literals[first[v]] .. literals[first[v + 1]]
+        vector<int> literals;
+
+        /**
+         * @brief Adds what the previous version proves about the backbone under v=true
+         *
+         * A dead variable had every literal in its (vacuous) old backbone, so
+         * it gets no hints.
+         *
+         * @param v Variable to be processed
+         * @param mark Scratch flags, 2 * (num_variables + 1) zeros (left zeroed)
+         * @param refuted Output: literals appended that are not in the backbone
+         * @param confirmed Output: literals appended that are in the backbone
+         */
+        void add_hints(int v, vector<char>& mark, vector<int>& refuted, vector<int>& confirmed) const {
+            if (hints == NO_HINTS || !known[v] || old_value[v] < 0) return;
+            const auto begin = literals.begin() + first[v];
+            const auto end = literals.begin() + first[v + 1];
+            if (hints == CONFIRM_OLD) {
+                // Every model of the current formula is a model of the previous one
+                confirmed.insert(confirmed.end(), begin, end);
+                return;
+            }
+
+            // Every model of the previous formula extends to the current one,
+            // so the witness of each literal missing from the old backbone remains
+            for (auto lit = begin; lit != end; ++lit) {
+                mark[*lit > 0 ? 2 * *lit : 2 * -*lit + 1] = 1;
+            }
+            const int num_vars = static_cast<int>(known.size()) - 1;
+            for (int x = 1; x <= num_vars; x++) {
+                if (!known[x] || x == v) continue;
+                if (old_value[x] <= 0 && !mark[2 * x]) refuted.push_back(x);
+                if (old_value[x] >= 0 && !mark[2 * x + 1]) refuted.push_back(-x);
+            }
+            for (auto lit = begin; lit != end; ++lit) {
+                mark[*lit > 0 ? 2 * *lit : 2 * -*lit + 1] = 0;
+            }
+        }
+    };
+
+    /**
+     * @struct SharedState
+     * @brief Data shared by all workers of one graph generation
+     *
+     * Read-only inputs are set up by the main thread before the workers start.
+     * Each edge row is written by exactly one worker (the one processing that
+     * position), so no locking is needed for them.
+     */
+    struct SharedState {
+        const vector<int>& global_bb;          // Global backbone indexed by variable
+        const vector<int>& global_literals;    // Global backbone literals
+        const vector<uint64_t>& requires_targets;  // Bitset: neither core nor auxiliary
+        const vector<uint64_t>& excludes_targets;  // Bitset: neither dead nor auxiliary
+        const vector<int>& vars_to_process;    // Variables in output order
+        const vector<int>& schedule;           // Positions in vars_to_process, in processing order
+        const vector<vector<int>>& members;    // Positions sharing the backbone of each scheduled one
+        int num_variables;
+        ModelStore* model_store;               // Shared model cache, or nullptr
+        TransitiveSchedule* transitive;        // Successor results, or nullptr
+        vector<EdgeRow>& rows;                 // Edges per position
+        JobQueue& jobs;                        // Unclaimed part of the schedule
+        atomic<int>& progress_counter;
+        bool instrument;                       // Collect a VariableReport per variable
+        int64_t conflict_budget;               // Conflicts per variable, negative for no limit
+        bool model_rotation;                   // Flip candidates in every model
+        const PreviousVersion* previous;       // Hints from the previous version, or nullptr
+    };
+
     /**
      * @struct ThreadWorker
      * @brief Thread worker structure for parallel variable processing
      *
-     * Each ThreadWorker instance represents a worker thread that processes a subset
-     * of variables to generate requires and excludes edges. The worker maintains
-     * thread-local buffers for edge accumulation and uses a pre-initialized
-     * BoneDiggerAPI instance.
+     * Each ThreadWorker instance represents a worker thread that processes
+     * chunks of the schedule claimed from the shared job queue to generate
+     * requires and excludes edges. Edges are
+     * written to the shared per-variable output buffers.
      *
-     * **CRITICAL REQUIREMENT**: The BoneDiggerAPI instance must be created and
-     * initialized in the main thread before being passed to the worker. Workers must
-     * NEVER initialize solver instances themselves, as BoneDiggerAPI is not
-     * thread-safe during initialization.
+     * The worker on the main thread uses the main BoneDiggerAPI instance. The
+     * other workers build their own instance in their thread (build_solver()),
+     * sharing the formula already parsed by the main instance, so solver setup
+     * and the first solve run concurrently instead of one after another.
      *
-     * @note Pre-initialization pattern: Solvers are created sequentially in the main
-     *       thread, then passed to workers for parallel variable processing only.
+     * @note BoneDiggerAPI instances are independent (no shared mutable state);
+     *       the only shared data is the immutable clause store, which is never
+     *       copied. Each instance must still be used by a single thread.
      */
     struct ThreadWorker {
         int thread_id;
-        int start_idx;
-        int end_idx;
+        bool print_progress;
 
-        // Thread-local resources (pre-initialized API passed from main thread)
+        // Thread-local resources (main thread's API, or built by build_solver())
         BoneDiggerAPI* bone_api;
-        stringstream requires_list;
-        stringstream excludes_list;
-
-        // Shared read-only data
-        const vector<int>& global_bb;
-        const vector<bool>& aux_vars;
-        const vector<int>& vars_to_process;
-        int num_variables;
+        unique_ptr<BoneDiggerAPI> own_api;
+        SharedState& shared;
+
+        // Scratch buffers reused across variables
+        vector<uint64_t> seen_true;
+        vector<uint64_t> seen_false;
+        vector<int> refuted;
+        vector<int> confirmed;
+        vector<int> literal_mark;
+        vector<char> hint_mark;
+        vector<int> assumptions;
+        vector<int> backbone;
+        vector<int> unknown;
+
+        // Edge targets of the variables processed by this worker (see EdgeRow)
+        vector<uint32_t> requires_edges;
+        vector<uint32_t> excludes_edges;
+
+        // Possible edge targets (DIMACS literals) of the positions whose
+        // backbone was left incomplete by the conflict budget
+        vector<pair<int, vector<int>>> unknown_rows;
+
+        // Checkpoint log of the finished variables, or nullptr
+        unique_ptr<CheckpointLog> checkpoint;
+        vector<uint32_t> record;
+
+        // Instrumentation (SharedState::instrument)
+        vector<VariableReport> reports;
+        double setup_seconds;
+        double busy_seconds;
 
         // Error handling
         bool success;
         string error_msg;
 
-        // Progress tracking
-        atomic<int>* progress_counter;
-
         /**
-         * @brief Constructs a thread worker for a range of indices in vars_to_process
+         * @brief Constructs a thread worker pulling from the shared job queue
          *
          * @param tid Thread identifier
-         * @param start First index in vars_to_process (inclusive)
-         * @param end Last index in vars_to_process (inclusive)
-         * @param api Pre-initialized BoneDiggerAPI instance (created in main thread)
-         * @param bb Global backbone vector (indexed array for O(1) lookup)
-         * @param aux Auxiliary variables flags (true if variable is aux_)
-         * @param vars Reference to vars_to_process vector
-         * @param num_vars Total number of variables in the formula
-         * @param progress Atomic counter for progress tracking
+         * @param api BoneDiggerAPI instance to use, or nullptr if the worker
+         *            builds its own with build_solver()
+         * @param state Data shared by all workers
+         * @param progress Whether to print progress after each variable
+         *                 (the worker running on the main thread)
          */
-        ThreadWorker(int tid, int start, int end,
-                    BoneDiggerAPI* api,
-                    const vector<int>& bb, const vector<bool>& aux,
-                    const vector<int>& vars, int num_vars,
-                    atomic<int>* progress)
-            : thread_id(tid), start_idx(start), end_idx(end),
-              bone_api(api), global_bb(bb), aux_vars(aux), vars_to_process(vars),
-              num_variables(num_vars), success(true), progress_counter(progress) {}
+        ThreadWorker(int tid, BoneDiggerAPI* api, SharedState& state, bool progress = false)
+            : thread_id(tid), print_progress(progress),
+              bone_api(api), shared(state), setup_seconds(0), busy_seconds(0), success(true) {}
 
         /**
-         * @brief Checks if a variable is an auxiliary variable
+         * @brief Builds the worker's own BoneDiggerAPI instance
+         *
+         * Runs in the worker thread. The formula is shared with source, which is
+         * only read (it may be in use by the main thread's worker meanwhile).
+         * On failure the job queue is cancelled.
+         *
+         * @param source Instance holding the parsed formula
+         * @param detector Backbone detector name
+         * @param callback Model callback feeding the shared model cache
+         * @return true if the instance is ready
          */
-        bool is_aux(int v) const {
-            return v < static_cast<int>(aux_vars.size()) && aux_vars[v];
+        bool build_solver(const BoneDiggerAPI& source, const string& detector,
+                          const BoneDiggerAPI::ModelCallback& callback) {
+            const auto start = chrono::steady_clock::now();
+            own_api = make_unique<BoneDiggerAPI>();
+            if (!own_api->share_formula(source)) {
+                error_msg = "Failed to share the formula with thread " + to_string(thread_id);
+            } else if (!own_api->create_backbone_detector(detector)) {
+                error_msg = "Failed to create detector for thread " + to_string(thread_id);
+            } else {
+                own_api->set_model_callback(callback);
+                bone_api = own_api.get();
+                setup_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                return true;
+            }
+            success = false;
+            shared.jobs.cancel();
+            return false;
+        }
+
+        /**
+         * @brief Tests bit i of a packed bitset
+         */
+        static bool has_bit(const vector<uint64_t>& bits, int i) {
+            return (bits[static_cast<size_t>(i) >> 6] >> (i & 63)) & 1;
         }
 
         /**
          * @brief Main worker thread execution function
          *
-         * Processes variables at indices [start_idx, end_idx] in vars_to_process,
-         * computing backbone with assumptions for each variable and extracting
-         * requires/excludes edges. Updates the shared progress counter atomically.
+         * Claims chunks of the schedule until it is exhausted, computing backbone
+         * with assumptions for each variable and extracting requires/excludes edges.
+         * Updates the shared progress counter atomically.
          *
          * Exception safety: Catches all exceptions and stores error messages
-         * for reporting in the main thread.
+         * for reporting in the main thread; the queue is cancelled so that the
+         * other workers stop early.
          */
         void run() {
             try {
-                // Process assigned index range in vars_to_process
-                for (int idx = start_idx; idx <= end_idx; idx++) {
-                    int v = vars_to_process[idx];
-                    process_variable(v);
-                    (*progress_counter)++;
+                const int total = static_cast<int>(shared.vars_to_process.size());
+                bone_api->set_conflict_budget(shared.conflict_budget);
+                bone_api->set_model_rotation(shared.model_rotation);
+                int begin, end;
+                while (shared.jobs.claim(begin, end)) {
+                    for (int idx = begin; idx < end; idx++) {
+                        const int pos = shared.schedule[idx];
+                        if (shared.instrument) {
+                            const auto start = chrono::steady_clock::now();
+                            process_variable(pos);
+                            const double seconds =
+                                chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                            busy_seconds += seconds;
+                            reports.push_back({pos, thread_id, seconds, backbone.size(), unknown.size(),
+                                               bone_api->get_last_query_stats()});
+                        } else {
+                            process_variable(pos);
+                        }
+                        // Incomplete variables are left out, so that resuming retries them
+                        if (checkpoint && unknown.empty()) save_checkpoint(pos);
+                        int completed = shared.progress_counter +=
+                            static_cast<int>(shared.members[pos].size());
+                        if (print_progress) {
+                            cout << "\rProgress: " << completed << " of " << total << " variables" << flush;
+                        }
+                    }
                 }
 
                 success = true;
@@ -366,54 +1144,1079 @@ public:
                 success = false;
                 error_msg = "Thread " + to_string(thread_id) +
                            " exception: " + e.what();
+                shared.jobs.cancel();
             } catch (...) {
                 success = false;
                 error_msg = "Thread " + to_string(thread_id) +
                            ": Unknown exception";
+                shared.jobs.cancel();
+            }
+        }
+
+        /**
+         * @brief Appends the edge rows of a finished variable to the checkpoint log
+         *
+         * @param pos Position of the scheduled variable in vars_to_process
+         * @throws runtime_error if the log cannot be written
+         */
+        void save_checkpoint(int pos) {
+            record.clear();
+            record.push_back(static_cast<uint32_t>(shared.members[pos].size()));
+            for (int member : shared.members[pos]) {
+                const EdgeRow& row = shared.rows[member];
+                record.push_back(static_cast<uint32_t>(shared.vars_to_process[member]));
+                record.push_back(row.num_requires);
+                record.push_back(row.num_excludes);
+                record.insert(record.end(), requires_edges.begin() + row.requires_begin,
+                              requires_edges.begin() + row.requires_begin + row.num_requires);
+                record.insert(record.end(), excludes_edges.begin() + row.excludes_begin,
+                              excludes_edges.begin() + row.excludes_begin + row.num_excludes);
+            }
+            if (!checkpoint->append(record)) {
+                throw runtime_error("could not write checkpoint " + checkpoint->path);
+            }
+        }
+
+        /**
+         * @brief Processes a single variable to extract dependency edges
+         *
+         * Computes the backbone assuming variable v is true, skipping the candidates
+         * already refuted by the shared model cache and accepting those already known
+         * from finished successors, then extracts:
+         * - **Requires edges**: If assuming v=true forces i=true (and i is not core)
+         * - **Excludes edges**: If assuming v=true forces i=false (and neither v nor i are dead)
+         *
+         * Extraction walks only the backbone literals (sorted by variable, so edges come
+         * out in the same order as a full scan) and tests the targets against packed
+         * bitsets; its cost does not depend on the number of variables. Edges involving
+         * auxiliary variables are excluded. The backbone is shared by every variable of
+         * the atomic set of v, so the edges of all of them are extracted here.
+         *
+         * @param pos Position of the variable in vars_to_process
+         */
+        void process_variable(int pos) {
+            const int v = shared.vars_to_process[pos];
+            const int num_variables = shared.num_variables;
+            const vector<int>& global_bb = shared.global_bb;
+
+            // Compute backbone assuming v=true
+            assumptions.assign(1, v);
+            refuted.clear();
+            confirmed.clear();
+            if (shared.model_store) {
+                shared.model_store->refuted_literals(v, seen_true, seen_false, refuted);
+            }
+            if (shared.transitive) {
+                literal_mark.resize(2 * static_cast<size_t>(num_variables) + 2, 0);
+                shared.transitive->confirmed_literals(v, shared.global_literals,
+                                                      literal_mark, confirmed);
+            }
+            if (shared.previous) {
+                hint_mark.resize(2 * static_cast<size_t>(num_variables) + 2, 0);
+                shared.previous->add_hints(v, hint_mark, refuted, confirmed);
+            }
+            bone_api->compute_backbone_with_assumptions(assumptions, refuted, confirmed, backbone);
+            bone_api->get_last_unknown(unknown);
+            if (shared.transitive) {
+                shared.transitive->publish(v, backbone);
+            }
+
+            for (int member : shared.members[pos]) {
+                const int u = shared.vars_to_process[member];
+                const bool u_dead = (global_bb[u] == -u);
+
+                // Extract requires edges (to variables that are neither core nor
+                // auxiliary) and excludes edges (to variables i >= u that are neither
+                // dead nor auxiliary, only if u is not dead)
+                EdgeRow& row = shared.rows[member];
+                row.worker = thread_id;
+                row.requires_begin = requires_edges.size();
+                row.excludes_begin = excludes_edges.size();
+                for (int lit : backbone) {
+                    if (lit > 0) {
+                        if (lit != u && has_bit(shared.requires_targets, lit)) {
+                            requires_edges.push_back(static_cast<uint32_t>(lit));
+                        }
+                    } else if (!u_dead && -lit >= u && has_bit(shared.excludes_targets, -lit)) {
+                        excludes_edges.push_back(static_cast<uint32_t>(-lit));
+                    }
+                }
+                row.num_requires = static_cast<uint32_t>(requires_edges.size() - row.requires_begin);
+                row.num_excludes = static_cast<uint32_t>(excludes_edges.size() - row.excludes_begin);
+
+                // Undecided candidates are possible edges, kept apart from the proven ones
+                if (!unknown.empty()) {
+                    vector<int> possible;
+                    for (int lit : unknown) {
+                        if (lit > 0 ? lit != u && has_bit(shared.requires_targets, lit)
+                                    : -lit != u && has_bit(shared.excludes_targets, -lit)) {
+                            possible.push_back(lit);
+                        }
+                    }
+                    unknown_rows.emplace_back(member, std::move(possible));
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief CPU quota of the cgroups of this process, in CPUs
+     *
+     * Reads cpu.max (cgroup v2) or cpu.cfs_quota_us and cpu.cfs_period_us
+     * (cgroup v1) of the cgroups listed in /proc/self/cgroup and of their
+     * ancestors up to the mounted root, which is the container's own cgroup
+     * when the paths of the host are not visible. Keeps the tightest quota.
+     *
+     * @return Quota in CPUs (fractional), or 0 if there is none or no cgroup
+     */
+    static double cgroup_cpu_quota() {
+        double tightest = 0;
+        auto consider = [&tightest](double quota, double period) {
+            if (quota > 0 && period > 0 && (tightest == 0 || quota / period < tightest)) {
+                tightest = quota / period;
+            }
+        };
+        ifstream groups("/proc/self/cgroup");
+        string line;
+        while (getline(groups, line)) {
+            // "<id>:<controllers>:<path>"; the cgroup v2 line has no controllers
+            const size_t first = line.find(':');
+            const size_t second = first == string::npos ? first : line.find(':', first + 1);
+            if (second == string::npos) continue;
+            const string controllers = line.substr(first + 1, second - first - 1);
+            const bool v2 = controllers.empty();
+            if (!v2 && ("," + controllers + ",").find(",cpu,") == string::npos) continue;
+            const string root = v2 ? "/sys/fs/cgroup" : "/sys/fs/cgroup/" + controllers;
+            string path = line.substr(second + 1);
+            while (true) {
+                const string dir = root + (path == "/" ? "" : path);
+                if (v2) {
+                    ifstream input(dir + "/cpu.max");
+                    string quota;
+                    double period = 0;
+                    if (input >> quota >> period && quota != "max") consider(atof(quota.c_str()), period);
+                } else {
+                    ifstream quota_input(dir + "/cpu.cfs_quota_us");
+                    ifstream period_input(dir + "/cpu.cfs_period_us");
+                    double quota = 0, period = 0;
+                    if (quota_input >> quota && period_input >> period) consider(quota, period);
+                }
+                if (path.empty() || path == "/") break;
+                path = path.substr(0, path.find_last_of('/'));
+                if (path.empty()) path = "/";
+            }
+        }
+        return tightest;
+    }
+
+    /**
+     * @brief CPUs this process may use
+     *
+     * thread::hardware_concurrency() counts every CPU of the machine, also in
+     * a container or under taskset. The process may only be scheduled on the
+     * CPUs of its affinity mask, and a cgroup CPU quota caps its CPU time; the
+     * quota is rounded up to whole CPUs.
+     *
+     * @param cpus Output: ids of the CPUs of the affinity mask
+     * @return Number of usable CPUs (at least 1)
+     */
+    static int available_cpus(vector<int>& cpus) {
+        cpus.clear();
+#ifdef __linux__
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                if (CPU_ISSET(cpu, &mask)) cpus.push_back(cpu);
+            }
+        }
+#endif
+        if (cpus.empty()) {
+            const int count = max(1, static_cast<int>(thread::hardware_concurrency()));
+            for (int cpu = 0; cpu < count; cpu++) cpus.push_back(cpu);
+        }
+        const double quota = cgroup_cpu_quota();
+        const int available = static_cast<int>(cpus.size());
+        return quota > 0 ? max(1, min(available, static_cast<int>(ceil(quota)))) : available;
+    }
+
+    /**
+     * @brief CPUs of one worker when every worker uses threads_per_worker CPUs
+     *
+     * Worker t gets the next threads_per_worker CPUs of the affinity mask
+     * after those of worker t-1, wrapping around when the workers need more
+     * CPUs than there are.
+     */
+    static vector<int> worker_cpus(const vector<int>& cpus, int worker, int threads_per_worker) {
+        vector<int> result;
+        for (int k = 0; k < threads_per_worker; k++) {
+            const int cpu = cpus[(static_cast<size_t>(worker) * threads_per_worker + k) % cpus.size()];
+            if (find(result.begin(), result.end(), cpu) == result.end()) result.push_back(cpu);
+        }
+        return result;
+    }
+
+    /**
+     * @struct ThreadPin
+     * @brief Pins the calling thread to a set of CPUs while it exists
+     *
+     * The previous affinity of the thread is restored on destruction (the main
+     * thread is pinned from the global backbone until worker 0 is done).
+     * Threads started by the pinned thread, such as the racing threads of the
+     * portfolio detector, inherit the set. Pinning is only supported on Linux;
+     * elsewhere the thread is left alone.
+     */
+    struct ThreadPin {
+#ifdef __linux__
+        cpu_set_t saved;
+#endif
+        bool pinned = false;
+
+        explicit ThreadPin(const vector<int>& cpus) {
+#ifdef __linux__
+            cpu_set_t mask;
+            CPU_ZERO(&mask);
+            for (int cpu : cpus) CPU_SET(cpu, &mask);
+            pinned = pthread_getaffinity_np(pthread_self(), sizeof(saved), &saved) == 0 &&
+                     pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+#else
+            (void)cpus;
+#endif
+        }
+
+        ~ThreadPin() {
+#ifdef __linux__
+            if (pinned) pthread_setaffinity_np(pthread_self(), sizeof(saved), &saved);
+#endif
+        }
+    };
+
+    /**
+     * @brief Creates a directory (and its parents) if it does not exist
+     *
+     * @param dir Directory path (empty means the current directory)
+     * @return true if the directory exists afterwards, false otherwise
+     */
+    bool ensure_directory(const string& dir) {
+        if (dir.empty() || filesystem::exists(dir)) return true;
+        try {
+            filesystem::create_directories(dir);
+        } catch (const exception& e) {
+            error_message = "Could not create output directory: " + dir + " - " + e.what();
+            cerr << error_message << endl;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Path of the checkpoint log of one worker
+     */
+    static string checkpoint_path(const string& output_base, int worker) {
+        return output_base + "__checkpoint_" + to_string(worker) + ".log";
+    }
+
+    /**
+     * @brief Builds the checkpoint header of the current run
+     *
+     * Hashes the DIMACS file (FNV-1a, 64 bits) so that logs of another formula
+     * with the same dimensions are not mistaken for this one.
+     *
+     * @param dimacs_path Path to the DIMACS file
+     * @param header Output header
+     * @return true if successful, false if the file cannot be read
+     */
+    bool make_checkpoint_header(const string& dimacs_path, CheckpointHeader& header) {
+        ifstream input(dimacs_path, ios::binary);
+        if (!input.is_open()) {
+            error_message = "Could not open file: " + dimacs_path;
+            return false;
+        }
+        uint64_t hash = 14695981039346656037ull;
+        vector<char> chunk(1 << 16);
+        while (input) {
+            input.read(chunk.data(), chunk.size());
+            for (streamsize i = 0; i < input.gcount(); i++) {
+                hash = (hash ^ static_cast<unsigned char>(chunk[i])) * 1099511628211ull;
+            }
+        }
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "S4VMCKP", 8);
+        header.version = 1;
+        header.num_variables = static_cast<uint32_t>(num_variables);
+        header.num_clauses = static_cast<uint32_t>(num_clauses);
+        header.flags = filter_auxiliary ? 1 : 0;
+        header.formula_hash = hash;
+        return true;
+    }
+
+    /**
+     * @brief Lists the checkpoint logs of an output base, by worker id
+     */
+    map<int, string> find_checkpoints(const string& output_dir, const string& basename) {
+        map<int, string> logs;
+        const string prefix = basename + "__checkpoint_";
+        const string suffix = ".log";
+        error_code ec;
+        for (const auto& entry : filesystem::directory_iterator(output_dir.empty() ? "." : output_dir, ec)) {
+            const string name = entry.path().filename().string();
+            if (name.size() <= prefix.size() + suffix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+                name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+                continue;
+            }
+            const string id = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+            if (id.find_first_not_of("0123456789") == string::npos && id.size() < 9) {
+                logs[stoi(id)] = entry.path().string();
+            }
+        }
+        return logs;
+    }
+
+    /**
+     * @brief Removes the checkpoint logs of an output base
+     */
+    void remove_checkpoints(const string& output_dir, const string& basename) {
+        for (const auto& log : find_checkpoints(output_dir, basename)) {
+            error_code ec;
+            filesystem::remove(log.second, ec);
+        }
+    }
+
+    /**
+     * @brief Path of the rows file of one shard
+     */
+    static string shard_path(const string& output_base, int index, int count) {
+        return output_base + "__shard_" + to_string(index) + "_of_" + to_string(count) + ".log";
+    }
+
+    /**
+     * @brief Lists the shard files of an output base (any shard count), numbered from 0
+     */
+    map<int, string> find_shards(const string& output_dir, const string& basename) {
+        map<int, string> shards;
+        const string prefix = basename + "__shard_";
+        const string suffix = ".log";
+        error_code ec;
+        for (const auto& entry : filesystem::directory_iterator(output_dir.empty() ? "." : output_dir, ec)) {
+            const string name = entry.path().filename().string();
+            if (name.size() <= prefix.size() + suffix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+                name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+                continue;
+            }
+            // "<index>_of_<count>", which also skips the checkpoint logs of shard runs
+            const string id = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+            const size_t of = id.find("_of_");
+            if (of != string::npos && of > 0 && of + 4 < id.size() &&
+                id.find_first_not_of("0123456789") == of &&
+                id.find_first_not_of("0123456789", of + 4) == string::npos) {
+                shards[static_cast<int>(shards.size())] = entry.path().string();
+            }
+        }
+        return shards;
+    }
+
+    /**
+     * @brief Writes the rows of a shard in checkpoint log format
+     *
+     * One record per scheduled position, as in the checkpoint logs, so that a
+     * merge run restores them with load_checkpoints(). The file is written
+     * under a temporary name and renamed when complete.
+     *
+     * @param path Shard file path
+     * @param header Header of the current run
+     * @param positions Scheduled positions of the shard
+     * @param incomplete Flag per position: backbone left incomplete (not written)
+     * @param vars_to_process Variables in output order
+     * @param members Positions sharing the backbone of each scheduled one
+     * @param rows Edge row of each position
+     * @param workers Workers holding the rows
+     * @return true if successful, false on a write error
+     */
+    bool write_shard(const string& path, const CheckpointHeader& header, const vector<int>& positions,
+                     const vector<char>& incomplete, const vector<int>& vars_to_process,
+                     const vector<vector<int>>& members, const vector<EdgeRow>& rows,
+                     const vector<ThreadWorker>& workers) {
+        const string temp_path = path + ".tmp";
+        bool ok;
+        {
+            CheckpointLog log;
+            ok = log.open(temp_path, header, 0);
+            vector<uint32_t> record;
+            for (size_t k = 0; ok && k < positions.size(); k++) {
+                const int pos = positions[k];
+                if (incomplete[pos]) continue;
+                record.assign(1, static_cast<uint32_t>(members[pos].size()));
+                for (int member : members[pos]) {
+                    const EdgeRow& row = rows[member];
+                    const ThreadWorker& worker = workers[row.worker];
+                    record.push_back(static_cast<uint32_t>(vars_to_process[member]));
+                    record.push_back(row.num_requires);
+                    record.push_back(row.num_excludes);
+                    record.insert(record.end(), worker.requires_edges.begin() + row.requires_begin,
+                                  worker.requires_edges.begin() + row.requires_begin + row.num_requires);
+                    record.insert(record.end(), worker.excludes_edges.begin() + row.excludes_begin,
+                                  worker.excludes_edges.begin() + row.excludes_begin + row.num_excludes);
+                }
+                ok = log.append(record);
+            }
+            ok = ok && log.flush();
+        }
+        error_code ec;
+        if (ok) filesystem::rename(temp_path, path, ec);
+        if (!ok || ec) {
+            filesystem::remove(temp_path, ec);
+            error_message = "Could not write shard file: " + path;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Restores the edge rows saved in the checkpoint logs of a previous run
+     *
+     * Logs whose header does not match the current run are ignored. Records are
+     * read until the first torn or inconsistent one; the valid prefix of each
+     * log is reported so that its worker can continue appending after it.
+     *
+     * @param logs Checkpoint logs by worker id (see find_checkpoints())
+     * @param header Header of the current run
+     * @param vars_to_process Variables in output order
+     * @param position Position of each variable in vars_to_process
+     * @param rows Output: rows of the restored positions (held by worker 0)
+     * @param restored Output: flag per position
+     * @param requires_edges Output: requires targets of the restored rows
+     * @param excludes_edges Output: excludes targets of the restored rows
+     * @param resumable Output: valid prefix length of each matching log
+     */
+    void load_checkpoints(const map<int, string>& logs, const CheckpointHeader& header,
+                          const vector<int>& vars_to_process, const vector<int>& position,
+                          vector<EdgeRow>& rows, vector<char>& restored,
+                          vector<uint32_t>& requires_edges, vector<uint32_t>& excludes_edges,
+                          map<int, uint64_t>& resumable) {
+        for (const auto& [worker, path] : logs) {
+            ifstream input(path, ios::binary);
+            vector<char> data((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+            if (data.size() < sizeof(CheckpointHeader) ||
+                memcmp(data.data(), &header, sizeof(CheckpointHeader)) != 0) {
+                cout << "Ignoring checkpoint of another run: " << path << endl;
+                continue;
+            }
+
+            size_t offset = sizeof(CheckpointHeader);
+            vector<uint32_t> words;
+            while (data.size() - offset >= 2 * sizeof(uint32_t)) {
+                uint32_t prefix[2];
+                memcpy(prefix, data.data() + offset, sizeof(prefix));
+                const size_t bytes = static_cast<size_t>(prefix[0]) * sizeof(uint32_t);
+                if (bytes > data.size() - offset - sizeof(prefix)) break;
+                words.resize(prefix[0]);
+                memcpy(words.data(), data.data() + offset + sizeof(prefix), bytes);
+                if (words.empty() || CheckpointLog::checksum(words.data(), words.size()) != prefix[1]) break;
+
+                // Validate the whole record before restoring any of its rows
+                bool valid = true;
+                size_t at = 1;
+                for (uint32_t m = 0; valid && m < words[0]; m++) {
+                    if (words.size() - at < 3) { valid = false; break; }
+                    const uint32_t var = words[at];
+                    const size_t count = static_cast<size_t>(words[at + 1]) + words[at + 2];
+                    valid = var >= 1 && var <= static_cast<uint32_t>(num_variables) &&
+                            vars_to_process[position[var]] == static_cast<int>(var) &&
+                            count <= words.size() - at - 3;
+                    for (size_t t = at + 3; valid && t < at + 3 + count; t++) {
+                        valid = words[t] >= 1 && words[t] <= static_cast<uint32_t>(num_variables);
+                    }
+                    at += 3 + count;
+                }
+                if (!valid || at != words.size()) break;
+
+                at = 1;
+                for (uint32_t m = 0; m < words[0]; m++) {
+                    const int pos = position[words[at]];
+                    EdgeRow& row = rows[pos];
+                    row.worker = 0;
+                    row.num_requires = words[at + 1];
+                    row.num_excludes = words[at + 2];
+                    row.requires_begin = requires_edges.size();
+                    row.excludes_begin = excludes_edges.size();
+                    at += 3;
+                    requires_edges.insert(requires_edges.end(), words.begin() + at,
+                                          words.begin() + at + row.num_requires);
+                    at += row.num_requires;
+                    excludes_edges.insert(excludes_edges.end(), words.begin() + at,
+                                          words.begin() + at + row.num_excludes);
+                    at += row.num_excludes;
+                    restored[pos] = 1;
+                }
+                offset += sizeof(prefix) + bytes;
+            }
+            resumable[worker] = offset;
+        }
+    }
+
+    /**
+     * @brief Reads the clauses of a DIMACS file in canonical form
+     *
+     * Literals are sorted and repeated ones dropped, and so are repeated
+     * clauses, so that the clause sets of two files can be compared directly.
+     *
+     * @param dimacs_path Path to the DIMACS file
+     * @param clauses Output: sorted clauses
+     * @param max_var Output: highest variable of any clause
+     * @return true if successful, false if the file cannot be read
+     */
+    bool read_clauses(const string& dimacs_path, vector<vector<int>>& clauses, int& max_var) {
+        ifstream input(dimacs_path);
+        if (!input.is_open()) {
+            error_message = "Could not open file: " + dimacs_path;
+            return false;
+        }
+        clauses.clear();
+        max_var = 0;
+        vector<int> clause;
+        string line;
+        while (getline(input, line)) {
+            if (line.empty() || line[0] == 'c' || line[0] == 'p' || line[0] == '%') continue;
+            const char* at = line.c_str();
+            char* end = nullptr;
+            for (long lit = strtol(at, &end, 10); end != at; lit = strtol(at, &end, 10)) {
+                at = end;
+                if (lit == 0) {
+                    sort(clause.begin(), clause.end());
+                    clause.erase(unique(clause.begin(), clause.end()), clause.end());
+                    clauses.push_back(clause);
+                    clause.clear();
+                } else {
+                    clause.push_back(static_cast<int>(lit));
+                    max_var = max(max_var, static_cast<int>(lit < 0 ? -lit : lit));
+                }
+            }
+        }
+        sort(clauses.begin(), clauses.end());
+        clauses.erase(unique(clauses.begin(), clauses.end()), clauses.end());
+        return true;
+    }
+
+    /**
+     * @brief Reads the vertices and edges of a Pajek file written by generate_graphs()
+     *
+     * @param path Pajek file path
+     * @param vertices Output: vertex ids (variables)
+     * @param edges Output: edges or arcs, as written
+     * @return true if successful, false if the file cannot be read
+     */
+    bool read_pajek(const string& path, vector<int>& vertices, vector<pair<int, int>>& edges) {
+        ifstream input(path);
+        if (!input.is_open()) {
+            error_message = "Could not open file: " + path;
+            return false;
+        }
+        bool in_vertices = false;
+        string line;
+        while (getline(input, line)) {
+            if (line.empty()) continue;
+            if (line[0] == '*') {
+                in_vertices = line.compare(0, 9, "*Vertices") == 0;
+                continue;
+            }
+            char* end = nullptr;
+            const long a = strtol(line.c_str(), &end, 10);
+            if (in_vertices) {
+                vertices.push_back(static_cast<int>(a));
+            } else {
+                edges.emplace_back(static_cast<int>(a), static_cast<int>(strtol(end, nullptr, 10)));
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Maps the results of a previous version of the model onto the current one
+     *
+     * Variables of both versions are matched by feature name (names used by
+     * more than one variable are not matched). The clauses of the previous
+     * version are renamed, a clause with an unmatched variable counting as
+     * removed, and compared with the current ones. A variable is touched when
+     * it occurs in a clause that was added or removed.
+     *
+     * The edges of a variable are reusable when no variable of its connected
+     * component in the current formula (variables sharing clauses, transitively)
+     * is touched and all the variables of the component that can be edge
+     * targets are known: the component then has exactly the clauses of a
+     * component of the previous version, and the backbone under v=true
+     * restricted to it is the old one (outside it, only core and dead features
+     * are forced, and they are never edge targets).
+     *
+     * @param previous_base Path of the previous outputs without suffix
+     * @param dimacs_path Path to the current DIMACS file
+     * @param aux_vars Auxiliary variables of the current run (never edge targets)
+     * @param previous Output: the mapped previous version
+     * @return true if successful, false if a file is missing or incomplete
+     */
+    bool load_previous_version(const string& previous_base, const string& dimacs_path,
+                               const vector<bool>& aux_vars, PreviousVersion& previous) {
+        const string unknown_path = previous_base + "__unknown.txt";
+        error_code ec;
+        if (filesystem::exists(unknown_path, ec) && filesystem::file_size(unknown_path, ec) > 0) {
+            error_message = "The previous version has undecided edges: " + unknown_path;
+            return false;
+        }
+
+        vector<vector<int>> old_clauses, new_clauses;
+        int old_max = 0, new_max = 0;
+        map<int, string> old_names, new_names;
+        vector<bool> ignored;
+        if (!read_clauses(previous_base + ".dimacs", old_clauses, old_max) ||
+            !read_feature_names(previous_base + ".dimacs", old_names, ignored) ||
+            !read_clauses(dimacs_path, new_clauses, new_max) ||
+            !read_feature_names(dimacs_path, new_names, ignored)) {
+            return false;
+        }
+
+        // Match the variables by unique feature name
+        unordered_map<string, int> new_by_name;
+        for (const auto& [var, name] : new_names) {
+            auto inserted = new_by_name.emplace(name, var);
+            if (!inserted.second) inserted.first->second = 0;
+        }
+        unordered_map<string, int> old_count;
+        for (const auto& entry : old_names) old_count[entry.second]++;
+        for (const auto& entry : old_names) old_max = max(old_max, entry.first);
+        vector<int> old_to_new(old_max + 1, 0);
+        for (const auto& [var, name] : old_names) {
+            auto match = new_by_name.find(name);
+            if (match != new_by_name.end() && match->second <= num_variables && old_count[name] == 1) {
+                old_to_new[var] = match->second;
+            }
+        }
+
+        // Rename the old clauses and compare both sorted clause sets
+        vector<char> touched(num_variables + 1, 0);
+        vector<vector<int>> renamed;
+        renamed.reserve(old_clauses.size());
+        for (const auto& clause : old_clauses) {
+            vector<int> mapped;
+            bool complete = true;
+            for (int lit : clause) {
+                const int var = old_to_new[abs(lit)];
+                if (var == 0) {
+                    complete = false;
+                } else {
+                    mapped.push_back(lit > 0 ? var : -var);
+                }
+            }
+            if (!complete) {
+                for (int lit : mapped) touched[abs(lit)] = 1;
+                previous.removed++;
+                continue;
+            }
+            sort(mapped.begin(), mapped.end());
+            renamed.push_back(std::move(mapped));
+        }
+        sort(renamed.begin(), renamed.end());
+        size_t i = 0, j = 0;
+        while (i < renamed.size() || j < new_clauses.size()) {
+            if (j == new_clauses.size() || (i < renamed.size() && renamed[i] < new_clauses[j])) {
+                for (int lit : renamed[i++]) touched[abs(lit)] = 1;
+                previous.removed++;
+            } else if (i == renamed.size() || new_clauses[j] < renamed[i]) {
+                for (int lit : new_clauses[j++]) touched[abs(lit)] = 1;
+                previous.added++;
+            } else {
+                i++;
+                j++;
+            }
+        }
+        renamed.clear();
+        old_clauses.clear();
+
+        // Old graphs and feature lists, renamed
+        vector<int> vertices, unused;
+        vector<pair<int, int>> arcs, edges;
+        if (!read_pajek(previous_base + "__requires.net", vertices, arcs) ||
+            !read_pajek(previous_base + "__excludes.net", unused, edges)) {
+            return false;
+        }
+        auto rename = [&old_to_new, old_max](int var) {
+            return var >= 1 && var <= old_max ? old_to_new[var] : 0;
+        };
+        previous.known.assign(num_variables + 1, 0);
+        previous.old_value.assign(num_variables + 1, 0);
+        for (int var : vertices) {
+            if (rename(var) != 0) previous.known[rename(var)] = 1;
+        }
+        for (int sign : {1, -1}) {
+            const string path = previous_base + (sign > 0 ? "__core.txt" : "__dead.txt");
+            ifstream input(path);
+            if (!input.is_open()) {
+                error_message = "Could not open file: " + path;
+                return false;
+            }
+            string line;
+            while (getline(input, line)) {
+                const int var = rename(atoi(line.c_str()));
+                if (var != 0) previous.old_value[var] = sign;
+            }
+        }
+
+        // Old edges per variable (excludes edges in both directions), sorted by target
+        vector<pair<int, int>> entries;
+        for (const auto& arc : arcs) {
+            const int u = rename(arc.first), w = rename(arc.second);
+            if (u != 0 && w != 0) entries.emplace_back(u, w);
+        }
+        for (const auto& edge : edges) {
+            const int u = rename(edge.first), w = rename(edge.second);
+            if (u == 0 || w == 0) continue;
+            entries.emplace_back(u, -w);
+            if (u != w) entries.emplace_back(w, -u);
+        }
+        sort(entries.begin(), entries.end(), [](const pair<int, int>& a, const pair<int, int>& b) {
+            return a.first != b.first ? a.first < b.first : abs(a.second) < abs(b.second);
+        });
+        previous.first.assign(num_variables + 2, 0);
+        previous.literals.clear();
+        previous.literals.reserve(entries.size());
+        for (const auto& entry : entries) {
+            previous.first[entry.first + 1]++;
+            previous.literals.push_back(entry.second);
+        }
+        for (int v = 0; v <= num_variables; v++) previous.first[v + 1] += previous.first[v];
+
+        // Connected components of the current formula (union-find on variables)
+        vector<int> parent(num_variables + 1);
+        for (int v = 0; v <= num_variables; v++) parent[v] = v;
+        auto find = [&parent](int v) {
+            while (parent[v] != v) v = parent[v] = parent[parent[v]];
+            return v;
+        };
+        for (const auto& clause : new_clauses) {
+            for (size_t k = 1; k < clause.size(); k++) {
+                parent[find(abs(clause[k]))] = find(abs(clause[0]));
+            }
+        }
+        vector<char> component_ok(num_variables + 1, 1);
+        for (int v = 1; v <= num_variables; v++) {
+            const bool target = !(v < static_cast<int>(aux_vars.size()) && aux_vars[v]);
+            if (touched[v] || (target && !previous.known[v])) component_ok[find(v)] = 0;
+        }
+        previous.reusable.assign(num_variables + 1, 0);
+        for (int v = 1; v <= num_variables; v++) {
+            previous.reusable[v] = component_ok[find(v)];
+        }
+
+        previous.hints = previous.added == 0 ? PreviousVersion::REFUTE_OTHERS
+                       : previous.removed == 0 ? PreviousVersion::CONFIRM_OLD
+                       : PreviousVersion::NO_HINTS;
+        return true;
+    }
+
+    /**
+     * @brief Writes the requires or excludes edges in output order
+     *
+     * Formats "source target" lines straight from the workers' packed rows into
+     * a fixed-size buffer with std::to_chars, so the graph text never exists in
+     * memory as a whole.
+     *
+     * @param out Output stream (the .net file)
+     * @param vars_to_process Variables in output order (row sources)
+     * @param rows Edge row of each position
+     * @param workers Workers holding the rows
+     * @param requires true for requires edges, false for excludes edges
+     */
+    void write_edges(ofstream& out, const vector<int>& vars_to_process,
+                     const vector<EdgeRow>& rows, const vector<ThreadWorker>& workers,
+                     bool requires) {
+        vector<char> buffer(1 << 16);
+        const size_t max_line = 24;  // Two 32-bit numbers, a space and a newline
+        size_t used = 0;
+        for (size_t pos = 0; pos < rows.size(); pos++) {
+            const EdgeRow& row = rows[pos];
+            const ThreadWorker& worker = workers[row.worker];
+            const uint32_t* targets = requires ? worker.requires_edges.data() + row.requires_begin
+                                               : worker.excludes_edges.data() + row.excludes_begin;
+            const uint32_t count = requires ? row.num_requires : row.num_excludes;
+            const int source = vars_to_process[pos];
+            for (uint32_t e = 0; e < count; e++) {
+                if (buffer.size() - used < max_line) {
+                    out.write(buffer.data(), used);
+                    used = 0;
+                }
+                char* line = buffer.data() + used;
+                char* p = to_chars(line, line + max_line, source).ptr;
+                *p++ = ' ';
+                p = to_chars(p, line + max_line, targets[e]).ptr;
+                *p++ = '\n';
+                used = p - buffer.data();
+            }
+        }
+        out.write(buffer.data(), used);
+    }
+
+    /**
+     * @brief Writes both graphs in the binary CSR format
+     *
+     * Lays out the sections described in GraphCSR.hh. Requires rows are
+     * streamed from the worker rows (sources are in ascending order, so their
+     * offsets are a prefix sum); the excludes graph is mirrored in memory first
+     * because every edge is stored in the rows of both endpoints.
+     *
+     * @param path Output path (`[basename]__graphs.csr`)
+     * @param vertex_count Vertex count of the Pajek files
+     * @param vertex_names Named vertices in Pajek order (variable, feature name)
+     * @param vars_to_process Variables in output order (row sources)
+     * @param rows Edge row of each position
+     * @param workers Workers holding the rows
+     * @return true if successful, false otherwise
+     */
+    bool write_graphs_csr(const string& path, int vertex_count,
+                          const vector<pair<int, string>>& vertex_names,
+                          const vector<int>& vars_to_process,
+                          const vector<EdgeRow>& rows, const vector<ThreadWorker>& workers) {
+        const size_t num_rows = static_cast<size_t>(num_variables) + 2;
+        auto align = [](uint64_t offset) { return (offset + 7) & ~uint64_t(7); };
+
+        // Row offsets of both graphs
+        vector<uint64_t> requires_offsets(num_rows, 0);
+        vector<uint64_t> excludes_offsets(num_rows, 0);
+        for (size_t pos = 0; pos < rows.size(); pos++) {
+            const EdgeRow& row = rows[pos];
+            const uint32_t* targets = workers[row.worker].excludes_edges.data() + row.excludes_begin;
+            const int source = vars_to_process[pos];
+            requires_offsets[source + 1] += row.num_requires;
+            excludes_offsets[source + 1] += row.num_excludes;
+            for (uint32_t e = 0; e < row.num_excludes; e++) {
+                excludes_offsets[targets[e] + 1]++;
+            }
+        }
+        for (size_t v = 1; v < num_rows; v++) {
+            requires_offsets[v] += requires_offsets[v - 1];
+            excludes_offsets[v] += excludes_offsets[v - 1];
+        }
+
+        // Mirror the excludes edges (targets are always greater than their
+        // source, a variable cannot exclude itself unless it is dead). Rows come
+        // out sorted because sources are visited in ascending order.
+        vector<uint32_t> excludes_targets(excludes_offsets[num_rows - 1]);
+        vector<uint64_t> cursor(excludes_offsets.begin(), excludes_offsets.end() - 1);
+        for (size_t pos = 0; pos < rows.size(); pos++) {
+            const EdgeRow& row = rows[pos];
+            const uint32_t* targets = workers[row.worker].excludes_edges.data() + row.excludes_begin;
+            const uint32_t source = static_cast<uint32_t>(vars_to_process[pos]);
+            for (uint32_t e = 0; e < row.num_excludes; e++) {
+                excludes_targets[cursor[source]++] = targets[e];
+                excludes_targets[cursor[targets[e]]++] = source;
+            }
+        }
+
+        // Name table
+        vector<CSRName> names;
+        vector<uint32_t> name_index(num_rows - 1, CSR_NO_NAME);
+        string strings;
+        for (const auto& [var, name] : vertex_names) {
+            if (var >= 1 && var <= num_variables) {
+                name_index[var] = static_cast<uint32_t>(names.size());
             }
+            names.push_back({static_cast<uint32_t>(var), static_cast<uint32_t>(name.size()),
+                             static_cast<uint64_t>(strings.size())});
+            strings += name;
         }
 
-        /**
-         * @brief Processes a single variable to extract dependency edges
-         *
-         * Computes the backbone assuming variable v is true, then extracts:
-         * - **Requires edges**: If assuming v=true forces i=true (and i is not core)
-         * - **Excludes edges**: If assuming v=true forces i=false (and neither v nor i are dead)
-         *
-         * The algorithm uses indexed arrays for O(1) backbone lookups to maximize performance.
-         * Edges involving auxiliary variables are excluded.
-         *
-         * @param v The variable to process (1-indexed)
-         */
-        void process_variable(int v) {
-            // Compute backbone assuming v=true
-            vector<int> assumptions = {v};
-            vector<int> line_vector =
-                bone_api->compute_backbone_with_assumptions(assumptions);
+        CSRHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, CSR_MAGIC, sizeof(CSR_MAGIC));
+        header.version = CSR_VERSION;
+        header.byte_order = CSR_BYTE_ORDER;
+        header.num_variables = static_cast<uint32_t>(num_variables);
+        header.vertex_count = static_cast<uint32_t>(vertex_count);
+        header.num_names = static_cast<uint32_t>(names.size());
+        header.requires_edges = requires_offsets[num_rows - 1];
+        header.excludes_edges = excludes_targets.size() / 2;
+        header.names_offset = sizeof(CSRHeader);
+        header.name_index_offset = header.names_offset + names.size() * sizeof(CSRName);
+        header.strings_offset = header.name_index_offset + name_index.size() * sizeof(uint32_t);
+        header.strings_size = strings.size();
+        header.requires_offsets_offset = align(header.strings_offset + strings.size());
+        header.requires_targets_offset = header.requires_offsets_offset + num_rows * sizeof(uint64_t);
+        header.excludes_offsets_offset =
+            align(header.requires_targets_offset + header.requires_edges * sizeof(uint32_t));
+        header.excludes_targets_offset = header.excludes_offsets_offset + num_rows * sizeof(uint64_t);
+        header.file_size = header.excludes_targets_offset + excludes_targets.size() * sizeof(uint32_t);
+
+        ofstream out(path, ios::binary);
+        if (!out.is_open()) {
+            error_message = "Could not create output file: " + path;
+            return false;
+        }
+        const char padding[8] = {0};
+        auto pad_to = [&](uint64_t offset) {
+            out.write(padding, offset - static_cast<uint64_t>(out.tellp()));
+        };
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(names.data()), names.size() * sizeof(CSRName));
+        out.write(reinterpret_cast<const char*>(name_index.data()), name_index.size() * sizeof(uint32_t));
+        out.write(strings.data(), strings.size());
+        pad_to(header.requires_offsets_offset);
+        out.write(reinterpret_cast<const char*>(requires_offsets.data()), num_rows * sizeof(uint64_t));
+        for (size_t pos = 0; pos < rows.size(); pos++) {
+            const EdgeRow& row = rows[pos];
+            const uint32_t* targets = workers[row.worker].requires_edges.data() + row.requires_begin;
+            out.write(reinterpret_cast<const char*>(targets), row.num_requires * sizeof(uint32_t));
+        }
+        pad_to(header.excludes_offsets_offset);
+        out.write(reinterpret_cast<const char*>(excludes_offsets.data()), num_rows * sizeof(uint64_t));
+        out.write(reinterpret_cast<const char*>(excludes_targets.data()),
+                  excludes_targets.size() * sizeof(uint32_t));
+
+        if (!out) {
+            error_message = "Could not write output file: " + path;
+            return false;
+        }
+        return true;
+    }
 
-            // Convert to indexed array for O(1) lookup
-            vector<int> line(num_variables + 1, 0);
-            for (int lit : line_vector) {
-                int var = abs(lit);
-                line[var] = lit;
+    /**
+     * @brief Escapes a string for a JSON document
+     */
+    static string json_string(const string& text) {
+        string quoted = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                quoted += '\\';
+                quoted += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char escape[8];
+                snprintf(escape, sizeof(escape), "\\u%04x", c);
+                quoted += escape;
+            } else {
+                quoted += c;
             }
+        }
+        return quoted + "\"";
+    }
 
-            // Extract requires edges (skip edges to auxiliary variables)
-            for (int i = 1; i <= num_variables; i++) {
-                if ((i != v) && (line[i] == i) && (global_bb[i] == 0) && !is_aux(i)) {
-                    requires_list << v << " " << i << "\n";
-                }
+    /**
+     * @brief Writes the JSON run report of an instrumented run
+     *
+     * Contains the phase timings, the work of the global backbone, per-thread
+     * busy and idle time, and one entry per computed backbone (variables are
+     * listed in output order; members of its atomic set share the entry).
+     * Idle time is the part of the variable loop a thread spent neither
+     * building its solver nor processing variables.
+     *
+     * @param path Report file path
+     * @param dimacs_path Input formula
+     * @param detector Backbone detector name
+     * @param phases Phase timings
+     * @param global_stats Work of the global backbone
+     * @param vars_to_process Variables in output order
+     * @param members Positions sharing the backbone of each scheduled position
+     * @param workers Workers, with their VariableReport entries
+     * @param restored_count Variables restored from checkpoints (not measured)
+     * @return true if successful, false otherwise
+     */
+    bool write_report(const string& path, const string& dimacs_path, const string& detector,
+                      const PhaseTimes& phases, const BoneDiggerAPI::QueryStats& global_stats,
+                      const vector<int>& vars_to_process, const vector<vector<int>>& members,
+                      const vector<ThreadWorker>& workers, int restored_count) {
+        ofstream out(path);
+        if (!out.is_open()) {
+            error_message = "Could not create report file: " + path;
+            return false;
+        }
+
+        vector<const VariableReport*> entries;
+        BoneDiggerAPI::QueryStats totals;
+        for (const auto& worker : workers) {
+            for (const auto& entry : worker.reports) {
+                entries.push_back(&entry);
+                totals.solves += entry.stats.solves;
+                totals.models += entry.stats.models;
+                totals.interrupted += entry.stats.interrupted;
+                totals.conflicts += entry.stats.conflicts;
+                totals.eliminated_by_models += entry.stats.eliminated_by_models;
+                totals.refuted += entry.stats.refuted;
+                totals.confirmed += entry.stats.confirmed;
             }
+        }
+        sort(entries.begin(), entries.end(), [](const VariableReport* a, const VariableReport* b) {
+            return a->position < b->position;
+        });
+
+        auto stats_fields = [&out](const BoneDiggerAPI::QueryStats& stats) {
+            out << "\"sat_calls\": " << stats.solves
+                << ", \"sat\": " << stats.models
+                << ", \"unsat\": " << stats.solves - stats.models - stats.interrupted
+                << ", \"interrupted\": " << stats.interrupted
+                << ", \"conflicts\": " << stats.conflicts
+                << ", \"eliminated_by_models\": " << stats.eliminated_by_models
+                << ", \"refuted_by_cache\": " << stats.refuted
+                << ", \"confirmed_without_sat\": " << stats.confirmed;
+        };
 
-            // Extract excludes edges (skip edges to auxiliary variables)
-            for (int i = v; i <= num_variables; i++) {
-                if ((line[i] == -i) && (global_bb[i] != -i) &&
-                    (global_bb[v] != -v) && !is_aux(i)) {
-                    excludes_list << v << " " << i << "\n";
-                }
+        out << fixed << setprecision(6);
+        out << "{\n";
+        out << "  \"input\": " << json_string(dimacs_path) << ",\n";
+        out << "  \"detector\": " << json_string(detector) << ",\n";
+        out << "  \"variables\": " << num_variables << ",\n";
+        out << "  \"clauses\": " << num_clauses << ",\n";
+        out << "  \"processed_variables\": " << vars_to_process.size() << ",\n";
+        out << "  \"computed_backbones\": " << entries.size() << ",\n";
+        out << "  \"restored_variables\": " << restored_count << ",\n";
+        out << "  \"reused_variables\": " << reused_variables << ",\n";
+        out << "  \"unknown_variables\": " << unknown_variables << ",\n";
+        out << "  \"phases\": {\"parse\": " << phases.parse
+            << ", \"global_backbone\": " << phases.global_backbone
+            << ", \"schedule\": " << phases.schedule
+            << ", \"variable_loop\": " << phases.variable_loop
+            << ", \"merge\": " << phases.merge
+            << ", \"write\": " << phases.write
+            << ", \"total\": " << phases.parse + phases.global_backbone + phases.schedule +
+                                   phases.variable_loop + phases.merge + phases.write << "},\n";
+        out << "  \"global_backbone\": {";
+        stats_fields(global_stats);
+        out << "},\n";
+        out << "  \"totals\": {";
+        stats_fields(totals);
+        out << "},\n";
+
+        out << "  \"threads\": [\n";
+        for (size_t t = 0; t < workers.size(); t++) {
+            const ThreadWorker& worker = workers[t];
+            const double idle = max(0.0, phases.variable_loop - worker.setup_seconds - worker.busy_seconds);
+            out << "    {\"id\": " << worker.thread_id
+                << ", \"backbones\": " << worker.reports.size()
+                << ", \"setup\": " << worker.setup_seconds
+                << ", \"busy\": " << worker.busy_seconds
+                << ", \"idle\": " << idle << "}"
+                << (t + 1 < workers.size() ? "," : "") << "\n";
+        }
+        out << "  ],\n";
+
+        out << "  \"backbones\": [\n";
+        for (size_t e = 0; e < entries.size(); e++) {
+            const VariableReport& entry = *entries[e];
+            out << "    {\"variable\": " << vars_to_process[entry.position] << ", \"atomic_set\": [";
+            const vector<int>& set = members[entry.position];
+            for (size_t m = 0; m < set.size(); m++) {
+                out << (m > 0 ? ", " : "") << vars_to_process[set[m]];
             }
+            out << "], \"thread\": " << entry.worker
+                << ", \"seconds\": " << entry.seconds
+                << ", \"backbone_size\": " << entry.backbone_size
+                << ", \"unknown\": " << entry.unknown << ", ";
+            stats_fields(entry.stats);
+            out << "}" << (e + 1 < entries.size() ? "," : "") << "\n";
         }
-    };
+        out << "  ]\n";
+        out << "}\n";
+
+        if (!out) {
+            error_message = "Could not write report file: " + path;
+            return false;
+        }
+        return true;
+    }
 
     /**
      * @brief Internal implementation of graph generation
@@ -423,35 +2226,41 @@ public:
      * **Pipeline Overview:**
      * 1. Load DIMACS file and create backbone detector
      * 2. Compute global backbone (core and dead features)
-     * 3. Validate thread count against CPU cores
-     * 4. Process variables (single-threaded or multi-threaded):
-     *    - For each non-backbone variable v, compute backbone assuming v=true
-     *    - Extract requires and excludes edges based on forced assignments
-     * 5. Extract feature names from DIMACS comments
-     * 6. Generate output files (Pajek graphs and feature lists)
+     * 3. Validate thread count against the available CPUs
+     * 4. Group equivalent variables into atomic sets (when enabled)
+     * 5. Process variables (single-threaded or multi-threaded), bottom-up along the
+     *    binary implication graph when transitive scheduling is enabled:
+     *    - For each atomic set representative v, compute backbone assuming v=true
+     *    - Extract requires and excludes edges of every member of the set
+     * 6. Extract feature names from DIMACS comments
+     * 7. Generate output files (Pajek graphs, feature lists and atomic sets)
      *
      * **Threading Strategy:**
-     * - Single-threaded mode: Sequential processing with immediate output
-     * - Multi-threaded mode:
-     *   1. Pre-create all BoneDiggerAPI instances in main thread (CRITICAL)
-     *   2. Create ThreadWorker instances with pre-initialized solvers
-     *   3. Launch worker threads with static range partitioning
-     *   4. Monitor progress with atomic counter
-     *   5. Merge results from thread-local buffers after join
+     * 1. Create ThreadWorker instances; worker 0 uses the main thread's solver
+     * 2. Launch the extra threads; each one builds its own BoneDiggerAPI instance
+     *    from the clauses parsed by the main instance (in parallel)
+     * 3. Run worker 0 on the main thread; all workers claim chunks of the
+     *    schedule from the shared JobQueue
+     * 4. Report progress from the main thread's worker (atomic counter)
+     * 5. Write the edge rows in output order after join (no intermediate text)
      *
      * **Thread Count Validation:**
-     * - Minimum: 1 thread
-     * - Maximum: Number of CPU cores (fail-fast if exceeded)
-     * - Effective: min(requested_threads, num_variables)
+     * - Minimum: 1 thread (0 selects all available CPUs)
+     * - Maximum: available CPUs, i.e. affinity mask capped by the cgroup CPU quota,
+     *   divided by the threads of the detector (3 for the portfolio) but at least 1
+     *   (fail-fast if exceeded, unless oversubscription is allowed)
+     * - Effective: min(requested_threads, number of atomic sets)
      *
      * @param dimacs_file Path to input DIMACS file (with or without .dimacs extension)
      * @param output_folder Output directory (empty string uses input file directory)
      * @param detector Backbone detector algorithm name (e.g., "CheckCandidatesOneByOne")
-     * @param num_of_threads Number of threads for parallel processing (1 for sequential)
+     * @param num_of_threads Number of threads for parallel processing (1 for sequential,
+     *                       0 for all available CPUs)
      * @return true if successful, false on error (error message in error_message field)
      *
      * @note The formula must be satisfiable. UNSAT formulas are not supported.
-     * @note Thread count exceeding CPU cores will fail with an error message.
+     * @note Thread count exceeding the available CPUs will fail with an error message,
+     *       unless oversubscription is allowed.
      *
      * @see BoneDiggerAPI::create_backbone_detector() for available detector algorithms
      * @see ThreadWorker for parallel processing implementation
@@ -462,12 +2271,34 @@ public:
         const string& detector,
         int num_of_threads
     ) {
+        if (shard_count < 1 || shard_index < 0 || shard_index >= shard_count) {
+            error_message = "Invalid shard " + to_string(shard_index) + " of " + to_string(shard_count);
+            cerr << error_message << endl;
+            return false;
+        }
+        if (merge_shards && shard_count > 1) {
+            error_message = "A shard run cannot merge shards";
+            cerr << error_message << endl;
+            return false;
+        }
+
         // Reset state
         num_variables = 0;
         num_clauses = 0;
+        unknown_variables = 0;
+        reused_variables = 0;
         global_backbone.clear();
         error_message.clear();
 
+        // Phase timings for the run report
+        PhaseTimes phases;
+        auto phase_start = chrono::steady_clock::now();
+        auto end_phase = [&phase_start](double& seconds) {
+            const auto now = chrono::steady_clock::now();
+            seconds = chrono::duration<double>(now - phase_start).count();
+            phase_start = now;
+        };
+
         // Construct DIMACS file path
         string dimacs_path = dimacs_file;
         if (dimacs_path.size() < 7 || dimacs_path.substr(dimacs_path.size() - 7) != ".dimacs") {
@@ -479,6 +2310,12 @@ public:
         string basename = get_basename(dimacs_file);
         string output_base = output_dir + "/" + basename;
 
+        // Checkpoint logs of a shard run are kept apart from the other shards'
+        const bool sharded = shard_count > 1;
+        const string run_basename = sharded ? basename + "__shard_" + to_string(shard_index) +
+                                              "_of_" + to_string(shard_count)
+                                            : basename;
+
         // Load DIMACS file
         if (!bone_api.read_dimacs(dimacs_path)) {
             error_message = "The input formula " + dimacs_path + " could not be loaded";
@@ -495,6 +2332,7 @@ public:
             cerr << error_message << endl;
             return false;
         }
+        bone_api.set_model_rotation(model_rotation);
 
         num_variables = bone_api.get_max_variable();
 
@@ -546,6 +2384,54 @@ public:
                 vars_to_process.push_back(v);
             }
         }
+        end_phase(phases.parse);
+
+        // Shared model cache: every model found from now on can refute
+        // candidates of the variables processed later
+        model_store.reset();
+        if (model_cache_size > 0) {
+            model_store = make_unique<ModelStore>(num_variables, static_cast<size_t>(model_cache_size));
+        }
+        ModelStore* store = model_store.get();
+        BoneDiggerAPI::ModelCallback store_model;
+        if (store) {
+            store_model = [store](const vector<bool>& model) { store->add(model); };
+        }
+        bone_api.set_model_callback(store_model);
+
+        // Validate thread count against the CPUs this process may use
+        vector<int> cpus;
+        const int available = available_cpus(cpus);
+        // The portfolio detector races its queries on several threads per
+        // worker; a single worker is always allowed
+        const int threads_per_worker = BoneDiggerAPI::get_detector_threads(detector);
+        const int max_threads = max(1, available / threads_per_worker);
+        if (num_of_threads == 0) {
+            num_of_threads = max_threads;
+        }
+
+        if (num_of_threads < 1) {
+            error_message = "num_of_threads must be at least 1 (or 0 for all available CPUs)";
+            cerr << error_message << endl;
+            return false;
+        }
+
+        if (num_of_threads > max_threads && !oversubscribe) {
+            error_message = "Requested " + to_string(num_of_threads) + " threads" +
+                           (threads_per_worker > 1 ? " (" + to_string(threads_per_worker) +
+                            " CPUs each with the " + detector + " detector)" : "") +
+                           " but only " + to_string(available) +
+                           " CPUs available (affinity mask and cgroup CPU quota). "
+                           "Reduce thread count or allow oversubscription.";
+            cerr << error_message << endl;
+            return false;
+        }
+
+        // The main thread runs worker 0 on the CPUs of worker 0, from the
+        // global backbone on: racing threads of the portfolio detector are
+        // started by its first query and keep the affinity they inherit
+        unique_ptr<ThreadPin> main_pin;
+        if (pin_threads) main_pin = make_unique<ThreadPin>(worker_cpus(cpus, 0, threads_per_worker));
 
         // Compute global backbone
         cout << "Computing core and dead features..." << endl;
@@ -558,151 +2444,335 @@ public:
             int var = abs(lit);
             bb[var] = lit;
         }
-
-        // Validate thread count
-        unsigned int max_threads = thread::hardware_concurrency();
-        if (max_threads == 0) max_threads = 4; // Fallback if detection fails
-
-        if (num_of_threads < 1) {
-            error_message = "num_of_threads must be at least 1";
-            cerr << error_message << endl;
-            return false;
-        }
-
-        if (num_of_threads > static_cast<int>(max_threads)) {
-            error_message = "Requested " + to_string(num_of_threads) +
-                           " threads but only " + to_string(max_threads) +
-                           " cores available. Reduce thread count.";
-            cerr << error_message << endl;
-            return false;
-        }
+        const BoneDiggerAPI::QueryStats global_stats = bone_api.get_last_query_stats();
+        end_phase(phases.global_backbone);
 
         // Calculate total variables to process (excluding aux vars when filtering)
         int total_to_process = static_cast<int>(vars_to_process.size());
 
-        // Cap effective threads at number of variables to process
-        int effective_threads = min(num_of_threads, total_to_process);
-
-        if (effective_threads > 1) {
-            cout << "Using " << effective_threads << " threads for parallel processing..." << endl;
+        // Collapse atomic sets: only the first variable of each set is scheduled,
+        // the others reuse its backbone
+        vector<pair<int, int>> binaries;
+        if (atomic_sets || transitive_scheduling) {
+            binaries = bone_api.get_binary_clauses();
+        }
+        vector<int> representative(num_variables + 1);
+        for (int v = 0; v <= num_variables; v++) {
+            representative[v] = v;
+        }
+        if (atomic_sets) {
+            find_atomic_sets(num_variables, binaries, vars_to_process, representative);
+        }
+        vector<int> position(num_variables + 1, 0);
+        for (int idx = 0; idx < total_to_process; idx++) {
+            position[vars_to_process[idx]] = idx;
+        }
+        vector<vector<int>> members(total_to_process);
+        vector<int> representatives;
+        for (int idx = 0; idx < total_to_process; idx++) {
+            const int v = vars_to_process[idx];
+            members[position[representative[v]]].push_back(idx);
+            if (representative[v] == v) representatives.push_back(v);
+        }
+        const int total_to_schedule = static_cast<int>(representatives.size());
+        if (atomic_sets) {
+            cout << "Found " << total_to_process - total_to_schedule
+                 << " variables equivalent to others (" << total_to_schedule
+                 << " backbones to compute)" << endl;
         }
 
-        stringstream excludes_list;
-        stringstream requires_list;
-
-        if (effective_threads == 1) {
-            // Single-threaded mode - iterate only over vars_to_process
-            for (int idx = 0; idx < total_to_process; idx++) {
-                int v = vars_to_process[idx];
-                cout << "\rProgress: " << (idx + 1) << " of " << total_to_process << " variables" << flush;
+        // Processing order: bottom-up along the binary implication graph when
+        // transitive scheduling is enabled, otherwise the output order
+        vector<int> schedule(total_to_schedule);
+        unique_ptr<TransitiveSchedule> transitive;
+        if (transitive_scheduling) {
+            transitive = make_unique<TransitiveSchedule>(num_variables, binaries,
+                                                         representatives, representative);
+            transitive->order(representatives);
+        }
+        for (int idx = 0; idx < total_to_schedule; idx++) {
+            schedule[idx] = position[representatives[idx]];
+        }
 
-                // Compute backbone assuming v=true
-                vector<int> assumptions = {v};
-                vector<int> line_vector = bone_api.compute_backbone_with_assumptions(assumptions);
+        // Packed flags for edge extraction: possible targets of requires edges
+        // (neither core nor auxiliary) and of excludes edges (neither dead nor auxiliary)
+        vector<uint64_t> requires_targets(static_cast<size_t>(num_variables) / 64 + 1, 0);
+        vector<uint64_t> excludes_targets(static_cast<size_t>(num_variables) / 64 + 1, 0);
+        for (int v = 1; v <= num_variables; v++) {
+            if (is_aux(v)) continue;
+            const uint64_t mask = uint64_t(1) << (v & 63);
+            if (bb[v] == 0) requires_targets[v >> 6] |= mask;
+            if (bb[v] != -v) excludes_targets[v >> 6] |= mask;
+        }
 
-                // Convert to indexed array for O(1) lookup
-                vector<int> line(num_variables + 1, 0);
-                for (int lit : line_vector) {
-                    int var = abs(lit);
-                    line[var] = lit;
+        // Edges are kept in packed per-worker rows and written in output order
+        vector<EdgeRow> rows(total_to_process);
+
+        // Sharding: this run only computes one contiguous block of the schedule,
+        // so that most successors of a variable are in its own shard
+        vector<int> shard_schedule;
+        int outside_shard = 0;
+        if (sharded) {
+            const size_t begin = schedule.size() * shard_index / shard_count;
+            const size_t end = schedule.size() * (shard_index + 1) / shard_count;
+            for (size_t idx = 0; idx < schedule.size(); idx++) {
+                if (idx >= begin && idx < end) {
+                    shard_schedule.push_back(schedule[idx]);
+                } else {
+                    outside_shard += static_cast<int>(members[schedule[idx]].size());
                 }
+            }
+            schedule = shard_schedule;
+            cout << "Shard " << shard_index << " of " << shard_count << ": "
+                 << schedule.size() << " of " << total_to_schedule << " backbones to compute" << endl;
+        }
 
-                // Extract requires edges (skip edges to auxiliary variables)
-                for (int i = 1; i <= num_variables; i++) {
-                    if ((i != v) && (line[i] == i) && (bb[i] == 0) && !is_aux(i)) {
-                        requires_list << v << " " << i << endl;
-                    }
+        // Checkpoints and shards: restore the rows finished by previous runs
+        // and drop their variables from the schedule
+        CheckpointHeader checkpoint_header;
+        vector<uint32_t> restored_requires;
+        vector<uint32_t> restored_excludes;
+        map<int, uint64_t> resumable_logs;
+        int restored_count = 0;
+        if (checkpointing || resume || sharded || merge_shards) {
+            if (!ensure_directory(output_dir) ||
+                !make_checkpoint_header(dimacs_path, checkpoint_header)) {
+                return false;
+            }
+        }
+        if (checkpointing || resume || merge_shards) {
+            if (resume || merge_shards) {
+                vector<char> restored(total_to_process, 0);
+                if (merge_shards) {
+                    const map<int, string> shards = find_shards(output_dir, basename);
+                    cout << "Merging " << shards.size() << " shard files" << endl;
+                    map<int, uint64_t> unused;
+                    load_checkpoints(shards, checkpoint_header, vars_to_process, position, rows,
+                                     restored, restored_requires, restored_excludes, unused);
                 }
-
-                // Extract excludes edges (skip edges to auxiliary variables)
-                for (int i = v; i <= num_variables; i++) {
-                    if ((line[i] == -i) && (bb[i] != -i) && (bb[v] != -v) && !is_aux(i)) {
-                        excludes_list << v << " " << i << endl;
+                if (resume) {
+                    load_checkpoints(find_checkpoints(output_dir, run_basename), checkpoint_header,
+                                     vars_to_process, position, rows, restored,
+                                     restored_requires, restored_excludes, resumable_logs);
+                }
+                vector<int> remaining;
+                vector<int> known;
+                for (int pos : schedule) {
+                    bool done = true;
+                    for (int member : members[pos]) done = done && restored[member];
+                    if (!done) {
+                        remaining.push_back(pos);
+                        continue;
+                    }
+                    restored_count += static_cast<int>(members[pos].size());
+                    if (transitive) {
+                        // Its requires targets are part of its backbone, enough
+                        // to keep the restored variable useful to its predecessors
+                        const EdgeRow& row = rows[pos];
+                        known.assign(1, vars_to_process[pos]);
+                        known.insert(known.end(), restored_requires.begin() + row.requires_begin,
+                                     restored_requires.begin() + row.requires_begin + row.num_requires);
+                        transitive->publish(vars_to_process[pos], known);
                     }
                 }
+                schedule.swap(remaining);
+                cout << (merge_shards ? "Merged: " : "Resuming: ") << restored_count << " of "
+                     << total_to_process << " variables restored from "
+                     << (merge_shards ? "shards" : "checkpoints") << endl;
+            } else {
+                remove_checkpoints(output_dir, run_basename);
             }
-            cout << endl;
-        } else {
-            // Multi-threaded mode
-            atomic<int> progress_counter(0);
+        }
 
-            // Pre-create and initialize BoneDiggerAPI instances (single-threaded)
-            cout << "Initializing " << effective_threads << " backbone solver instances..." << endl;
-            vector<unique_ptr<BoneDiggerAPI>> apis;
-            for (int t = 0; t < effective_threads; t++) {
-                apis.emplace_back(make_unique<BoneDiggerAPI>());
-                if (!apis[t]->read_dimacs(dimacs_path)) {
-                    error_message = "Failed to load DIMACS for thread " + to_string(t);
-                    cerr << error_message << endl;
-                    return false;
+        // Previous version: copy the rows it still proves exact and drop their
+        // variables from the schedule; the other variables get its hints
+        unique_ptr<PreviousVersion> previous;
+        if (!previous_version.empty()) {
+            previous = make_unique<PreviousVersion>();
+            if (!load_previous_version(previous_version, dimacs_path, aux_vars, *previous)) {
+                cerr << error_message << endl;
+                return false;
+            }
+            vector<int> remaining;
+            vector<int> known;
+            for (int pos : schedule) {
+                bool reusable = true;
+                for (int member : members[pos]) {
+                    reusable = reusable && previous->reusable[vars_to_process[member]];
                 }
-                if (!apis[t]->create_backbone_detector(detector)) {
-                    error_message = "Failed to create detector for thread " + to_string(t);
-                    cerr << error_message << endl;
-                    return false;
+                if (!reusable) {
+                    remaining.push_back(pos);
+                    continue;
+                }
+                for (int member : members[pos]) {
+                    const int u = vars_to_process[member];
+                    const bool u_dead = (bb[u] == -u);
+                    EdgeRow& row = rows[member];
+                    row.worker = 0;
+                    row.requires_begin = restored_requires.size();
+                    row.excludes_begin = restored_excludes.size();
+                    for (size_t k = previous->first[u]; k < previous->first[u + 1]; k++) {
+                        const int lit = previous->literals[k];
+                        if (lit > 0) {
+                            if (lit != u && ThreadWorker::has_bit(requires_targets, lit)) {
+                                restored_requires.push_back(static_cast<uint32_t>(lit));
+                            }
+                        } else if (!u_dead && -lit >= u && ThreadWorker::has_bit(excludes_targets, -lit)) {
+                            restored_excludes.push_back(static_cast<uint32_t>(-lit));
+                        }
+                    }
+                    row.num_requires = static_cast<uint32_t>(restored_requires.size() - row.requires_begin);
+                    row.num_excludes = static_cast<uint32_t>(restored_excludes.size() - row.excludes_begin);
+                }
+                reused_variables += static_cast<int>(members[pos].size());
+                if (transitive) {
+                    const EdgeRow& row = rows[pos];
+                    known.assign(1, vars_to_process[pos]);
+                    known.insert(known.end(), restored_requires.begin() + row.requires_begin,
+                                 restored_requires.begin() + row.requires_begin + row.num_requires);
+                    transitive->publish(vars_to_process[pos], known);
                 }
             }
+            schedule.swap(remaining);
+            cout << "Previous version: " << reused_variables << " of " << total_to_process
+                 << " variables reused (" << previous->added << " clauses added, "
+                 << previous->removed << " removed)" << endl;
+        }
+        const int remaining_to_schedule = static_cast<int>(schedule.size());
 
-            // Create thread workers with pre-initialized APIs
-            vector<ThreadWorker> workers;
-            workers.reserve(effective_threads); // Prevent reallocation
-            vector<thread> threads;
-            threads.reserve(effective_threads);
-
-            // Distribute vars_to_process indices across threads
-            int vars_per_thread = total_to_process / effective_threads;
-            int remainder = total_to_process % effective_threads;
+        // Cap effective threads at number of backbones to compute
+        int effective_threads = max(1, min(num_of_threads, remaining_to_schedule));
 
-            int current_idx = 0;
+        if (effective_threads > 1) {
+            cout << "Using " << effective_threads << " threads for parallel processing..." << endl;
+        }
+        if (pin_threads) {
+            cout << "Pinning worker threads to CPUs";
             for (int t = 0; t < effective_threads; t++) {
-                int start_idx = current_idx;
-                int count = vars_per_thread + (t < remainder ? 1 : 0);
-                int end_idx = start_idx + count - 1;
+                const vector<int> set = worker_cpus(cpus, t, threads_per_worker);
+                cout << (t > 0 ? ", " : " ");
+                for (size_t k = 0; k < set.size(); k++) {
+                    cout << (k > 0 ? "+" : "") << set[k];
+                }
+            }
+            cout << endl;
+        }
 
-                workers.emplace_back(ThreadWorker(
-                    t, start_idx, end_idx,
-                    apis[t].get(), bb, aux_vars, vars_to_process, num_variables,
-                    &progress_counter
-                ));
+        end_phase(phases.schedule);
 
-                current_idx = end_idx + 1;
-            }
+        atomic<int> progress_counter(restored_count + reused_variables + outside_shard);
+        JobQueue jobs(remaining_to_schedule, effective_threads);
+        SharedState shared{bb, bb_vector, requires_targets, excludes_targets,
+                           vars_to_process, schedule, members,
+                           num_variables, store, transitive.get(), rows,
+                           jobs, progress_counter, !report_file.empty(), conflict_budget,
+                           model_rotation, previous.get()};
 
-            // Launch threads
+        // Create thread workers; worker 0 runs on the main thread with the
+        // main solver and reports progress, the others build their own solver
+        // (sharing the clauses parsed once above) in their thread
+        if (effective_threads > 1) {
+            cout << "Initializing " << effective_threads - 1 << " additional backbone solver instances in parallel..." << endl;
+        }
+        vector<ThreadWorker> workers;
+        workers.reserve(effective_threads); // Prevent reallocation
+        workers.emplace_back(0, &bone_api, shared, true);
+        for (int t = 1; t < effective_threads; t++) {
+            workers.emplace_back(t, nullptr, shared);
+        }
+        workers[0].requires_edges.swap(restored_requires);
+        workers[0].excludes_edges.swap(restored_excludes);
+        if (checkpointing || resume) {
             for (auto& worker : workers) {
-                threads.emplace_back([&worker]() { worker.run(); });
+                const string log_path = checkpoint_path(output_dir + "/" + run_basename, worker.thread_id);
+                auto resumable = resumable_logs.find(worker.thread_id);
+                worker.checkpoint = make_unique<CheckpointLog>();
+                if (!worker.checkpoint->open(log_path, checkpoint_header,
+                                             resumable == resumable_logs.end() ? 0 : resumable->second)) {
+                    error_message = "Could not create checkpoint file: " + log_path;
+                    cerr << error_message << endl;
+                    return false;
+                }
             }
+        }
 
-            // Progress monitoring
-            while (progress_counter < total_to_process) {
-                int completed = progress_counter.load();
-                cout << "\rProgress: " << completed << " of "
-                     << total_to_process << " variables" << flush;
-                this_thread::sleep_for(chrono::milliseconds(100));
-            }
+        // Launch the extra threads, then join the work on the main thread
+        vector<thread> threads;
+        threads.reserve(effective_threads - 1);
+        for (int t = 1; t < effective_threads; t++) {
+            ThreadWorker* worker = &workers[t];
+            const vector<int> cpu_set = worker_cpus(cpus, t, threads_per_worker);
+            threads.emplace_back([worker, this, &detector, &store_model, cpu_set]() {
+                unique_ptr<ThreadPin> pin;
+                if (pin_threads) pin = make_unique<ThreadPin>(cpu_set);
+                if (worker->build_solver(bone_api, detector, store_model)) {
+                    worker->run();
+                }
+            });
+        }
+        workers[0].run();
+        main_pin.reset();
+
+        // Wait for all workers
+        for (auto& thread : threads) {
+            thread.join();
+        }
 
-            // Wait for all workers
-            for (auto& thread : threads) {
-                thread.join();
+        // Check for errors (fail-fast)
+        for (const auto& worker : workers) {
+            if (!worker.success) {
+                cout << endl;
+                error_message = worker.error_msg;
+                cerr << error_message << endl;
+                return false;
             }
+        }
+        end_phase(phases.variable_loop);
 
-            cout << "\rProgress: " << total_to_process << " of "
-                 << total_to_process << " variables" << endl;
+        cout << "\rProgress: " << total_to_process << " of "
+             << total_to_process << " variables" << endl;
 
-            // Check for errors (fail-fast)
+        // The solvers are no longer needed; the edge rows stay in the workers
+        // (the checkpoint logs are flushed and kept until the outputs are written)
+        for (auto& worker : workers) {
+            worker.own_api.reset();
+            worker.checkpoint.reset();
+        }
+
+        // A shard only writes its rows (the complete ones); merging the shards
+        // writes the output files
+        if (sharded) {
+            vector<char> incomplete(total_to_process, 0);
             for (const auto& worker : workers) {
-                if (!worker.success) {
-                    error_message = worker.error_msg;
+                for (const auto& entry : worker.unknown_rows) {
+                    incomplete[entry.first] = 1;
+                    unknown_variables++;
+                }
+            }
+            const string path = shard_path(output_base, shard_index, shard_count);
+            cout << "Saving to " << path << endl;
+            if (!write_shard(path, checkpoint_header, shard_schedule, incomplete,
+                             vars_to_process, members, rows, workers)) {
+                cerr << error_message << endl;
+                return false;
+            }
+            if (unknown_variables > 0) {
+                cout << unknown_variables << " variables ran out of conflict budget; "
+                     << "merging computes them again" << endl;
+            } else if (checkpointing || resume) {
+                remove_checkpoints(output_dir, run_basename);
+            }
+            end_phase(phases.write);
+            if (!report_file.empty()) {
+                cout << "Saving to " << report_file << endl;
+                if (!write_report(report_file, dimacs_path, detector, phases, global_stats,
+                                  vars_to_process, members, workers, restored_count)) {
                     cerr << error_message << endl;
                     return false;
                 }
             }
-
-            // Merge results from all threads
-            for (const auto& worker : workers) {
-                requires_list << worker.requires_list.str();
-                excludes_list << worker.excludes_list.str();
-            }
+            cout << "Done!" << endl;
+            return true;
         }
 
         // Extract feature names from DIMACS comments (if not already read for filtering)
@@ -710,6 +2780,7 @@ public:
         stringstream feat_stream;
         stringstream core_stream;
         stringstream dead_stream;
+        vector<pair<int, string>> vertex_names;  // Only kept for the binary output
 
         ifstream dimacs_input(dimacs_path);
         string line_str;
@@ -751,6 +2822,9 @@ public:
                     if (has_words) {
                         feat_stream << endl;
                         feature_map[var_number] = full_name.str();
+                        if (binary_output) {
+                            vertex_names.emplace_back(var_number, full_name.str());
+                        }
 
                         if (bb[var_number] > 0) {
                             core_stream << endl;
@@ -762,16 +2836,11 @@ public:
             }
         }
         dimacs_input.close();
+        end_phase(phases.merge);
 
         // Create output directory if it doesn't exist
-        if (!output_dir.empty() && !filesystem::exists(output_dir)) {
-            try {
-                filesystem::create_directories(output_dir);
-            } catch (const exception& e) {
-                error_message = "Could not create output directory: " + output_dir + " - " + e.what();
-                cerr << error_message << endl;
-                return false;
-            }
+        if (!ensure_directory(output_dir)) {
+            return false;
         }
 
         // Write output files
@@ -808,7 +2877,7 @@ public:
         outFile << "*Vertices " << vertex_count << endl;
         outFile << feat_stream.str();
         outFile << "*Arcs" << endl;
-        outFile << requires_list.str();
+        write_edges(outFile, vars_to_process, rows, workers, true);
         outFile << endl;
         outFile.close();
 
@@ -821,10 +2890,87 @@ public:
         outFile << "*Vertices " << vertex_count << endl;
         outFile << feat_stream.str();
         outFile << "*Edges" << endl;
-        outFile << excludes_list.str();
+        write_edges(outFile, vars_to_process, rows, workers, false);
         outFile << endl;
         outFile.close();
 
+        if (binary_output) {
+            cout << "Saving to " << output_base << "__graphs.csr" << endl;
+            if (!write_graphs_csr(output_base + "__graphs.csr", vertex_count, vertex_names,
+                                  vars_to_process, rows, workers)) {
+                return false;
+            }
+        }
+
+        if (write_atomic_sets) {
+            cout << "Saving to " << output_base << "__atomic_sets.txt" << endl;
+            outFile.open(output_base + "__atomic_sets.txt");
+            if (!outFile.is_open()) {
+                error_message = "Could not create output file: " + output_base + "__atomic_sets.txt";
+                return false;
+            }
+            for (int idx = 0; idx < total_to_process; idx++) {
+                if (members[idx].size() < 2) continue;
+                for (size_t m = 0; m < members[idx].size(); m++) {
+                    if (m > 0) outFile << " ";
+                    outFile << vars_to_process[members[idx][m]];
+                }
+                outFile << endl;
+            }
+            outFile.close();
+        }
+
+        // Variables whose backbone the conflict budget left incomplete, with
+        // their possible edges
+        if (conflict_budget >= 0) {
+            vector<const vector<int>*> possible(total_to_process, nullptr);
+            for (const auto& worker : workers) {
+                for (const auto& entry : worker.unknown_rows) {
+                    possible[entry.first] = &entry.second;
+                }
+            }
+            cout << "Saving to " << output_base << "__unknown.txt" << endl;
+            outFile.open(output_base + "__unknown.txt");
+            if (!outFile.is_open()) {
+                error_message = "Could not create output file: " + output_base + "__unknown.txt";
+                return false;
+            }
+            for (int idx = 0; idx < total_to_process; idx++) {
+                if (!possible[idx]) continue;
+                unknown_variables++;
+                outFile << vars_to_process[idx];
+                for (int lit : *possible[idx]) {
+                    outFile << " " << lit;
+                }
+                outFile << endl;
+            }
+            outFile.close();
+            if (unknown_variables > 0) {
+                cout << unknown_variables << " variables ran out of conflict budget; "
+                     << "their undecided edges are in " << output_base << "__unknown.txt" << endl;
+            }
+        }
+
+        // All results are on disk; the checkpoints are no longer needed, unless
+        // a resumed run with a larger budget should retry the incomplete variables
+        if (checkpointing || resume) {
+            if (unknown_variables > 0) {
+                cout << "Keeping the checkpoints (resume to retry the incomplete variables)" << endl;
+            } else {
+                remove_checkpoints(output_dir, basename);
+            }
+        }
+        end_phase(phases.write);
+
+        if (!report_file.empty()) {
+            cout << "Saving to " << report_file << endl;
+            if (!write_report(report_file, dimacs_path, detector, phases, global_stats,
+                              vars_to_process, members, workers, restored_count)) {
+                cerr << error_message << endl;
+                return false;
+            }
+        }
+
         cout << "Done!" << endl;
         return true;
     }
@@ -885,6 +3031,14 @@ vector<int> Dimacs2GraphsAPI::get_global_backbone() const {
     return pimpl->global_backbone;
 }
 
+int Dimacs2GraphsAPI::get_num_unknown_variables() const {
+    return pimpl->unknown_variables;
+}
+
+int Dimacs2GraphsAPI::get_num_reused_variables() const {
+    return pimpl->reused_variables;
+}
+
 /**
  * @brief Gets the last error message
  * @return Error message string (empty if no error)
@@ -900,3 +3054,134 @@ string Dimacs2GraphsAPI::get_error_message() const {
 void Dimacs2GraphsAPI::set_filter_auxiliary(bool filter) {
     pimpl->filter_auxiliary = filter;
 }
+
+/**
+ * @brief Sets the capacity of the shared model cache
+ * @param max_models Maximum number of cached models (0 disables the cache)
+ */
+void Dimacs2GraphsAPI::set_model_cache_size(int max_models) {
+    pimpl->model_cache_size = max(0, max_models);
+}
+
+/**
+ * @brief Sets whether variables are processed bottom-up along the implication graph
+ * @param enabled If true, successors' backbones are reused as confirmed literals
+ */
+void Dimacs2GraphsAPI::set_transitive_scheduling(bool enabled) {
+    pimpl->transitive_scheduling = enabled;
+}
+
+/**
+ * @brief Sets whether equivalent variables share one backbone computation
+ * @param enabled If true, atomic sets are collapsed to one representative
+ */
+void Dimacs2GraphsAPI::set_atomic_sets(bool enabled) {
+    pimpl->atomic_sets = enabled;
+}
+
+/**
+ * @brief Sets whether the atomic sets are written to [basename]__atomic_sets.txt
+ * @param enabled If true, the file is written
+ */
+void Dimacs2GraphsAPI::set_write_atomic_sets(bool enabled) {
+    pimpl->write_atomic_sets = enabled;
+}
+
+/**
+ * @brief Sets whether both graphs are also written to [basename]__graphs.csr
+ * @param enabled If true, the binary CSR file is written
+ */
+void Dimacs2GraphsAPI::set_binary_output(bool enabled) {
+    pimpl->binary_output = enabled;
+}
+
+/**
+ * @brief Sets whether finished variables are logged to checkpoint files
+ * @param enabled If true, [basename]__checkpoint_<worker>.log files are kept during the run
+ */
+void Dimacs2GraphsAPI::set_checkpointing(bool enabled) {
+    pimpl->checkpointing = enabled;
+}
+
+/**
+ * @brief Sets whether the checkpoints of a previous run are restored
+ * @param enabled If true, variables found in the checkpoint files are skipped
+ */
+void Dimacs2GraphsAPI::set_resume(bool enabled) {
+    pimpl->resume = enabled;
+}
+
+/**
+ * @brief Sets the file of the JSON run report
+ * @param path Report file path, or empty to disable the report
+ */
+void Dimacs2GraphsAPI::set_report_file(const string& path) {
+    pimpl->report_file = path;
+}
+
+/**
+ * @brief Sets the conflict budget of each variable
+ * @param conflicts Conflicts per backbone query, or negative for no limit
+ */
+void Dimacs2GraphsAPI::set_conflict_budget(int64_t conflicts) {
+    pimpl->conflict_budget = conflicts;
+}
+
+/**
+ * @brief Enables model rotation in the backbone detectors
+ * @param enabled true to refute candidates by flipping them in each model
+ */
+void Dimacs2GraphsAPI::set_model_rotation(bool enabled) {
+    pimpl->model_rotation = enabled;
+}
+
+/**
+ * @brief Sets the previous version of the model whose results are reused
+ * @param previous_base Path of the previous outputs without suffix, or empty to disable
+ */
+void Dimacs2GraphsAPI::set_previous_version(const string& previous_base) {
+    pimpl->previous_version = previous_base;
+}
+
+/**
+ * @brief Restricts the run to one shard of the schedule
+ * @param index Shard to compute (0 to count - 1)
+ * @param count Number of shards, or 1 to compute everything
+ */
+void Dimacs2GraphsAPI::set_shard(int index, int count) {
+    pimpl->shard_index = index;
+    pimpl->shard_count = count;
+}
+
+/**
+ * @brief Sets whether the shard files of the output folder are merged
+ * @param enabled If true, restore the rows of the shard files
+ */
+void Dimacs2GraphsAPI::set_merge_shards(bool enabled) {
+    pimpl->merge_shards = enabled;
+}
+
+/**
+ * @brief Sets whether worker threads are pinned to CPUs
+ * @param enabled If true, worker t runs on the t-th CPU of the affinity mask
+ */
+void Dimacs2GraphsAPI::set_pin_threads(bool enabled) {
+    pimpl->pin_threads = enabled;
+}
+
+/**
+ * @brief Sets whether more threads than available CPUs may be requested
+ * @param enabled If true, the thread count is not capped by the available CPUs
+ */
+void Dimacs2GraphsAPI::set_oversubscribe(bool enabled) {
+    pimpl->oversubscribe = enabled;
+}
+
+/**
+ * @brief Gets the number of CPUs this process may use
+ * @return CPUs of the affinity mask, capped by the cgroup CPU quota
+ */
+int Dimacs2GraphsAPI::get_available_cpus() {
+    vector<int> cpus;
+    return Impl::available_cpus(cpus);
+}
@@ -35,21 +35,19 @@
  * To accelerate processing of large formulas with hundreds or thousands of variables,
  * the algorithm uses **multi-threaded parallel processing** with a critical thread safety pattern:
  *
- * **Pre-Initialization Pattern (CRITICAL):**
+ * **Initialization Pattern:**
  * ```
  * Main Thread:
- *   1. Create N BackboneSolverAPI instances (one per thread)
- *   2. Initialize each solver sequentially:
- *      - Read DIMACS file
- *      - Create backbone detector
- *   3. Launch N worker threads, passing pre-initialized solvers
+ *   1. Parse the DIMACS file once (main BackboneSolverAPI instance)
+ *   2. Launch N-1 worker threads and work as worker 0
  *
  * Worker Threads (parallel):
- *   4. Process assigned variable range [start, end]
+ *   3. Build an own solver instance sharing the parsed clauses (read-only)
+ *   4. Claim chunks of the variable schedule from a shared queue
  *   5. For each variable:
  *      - Compute backbone with assumptions
  *      - Extract requires/excludes relationships
- *      - Store results in thread-local buffers
+ *      - Store edge targets in packed thread-local rows
  *   6. Return results to main thread
  *
  * Main Thread:
@@ -57,21 +55,19 @@
  *   8. Write output files
  * ```
  *
- * **Why Pre-Initialization?**
- * - BackboneSolverAPI is NOT thread-safe during initialization
- * - File I/O and solver setup must occur in the main thread
- * - Only the backbone computation itself is parallelized
+ * **Why Share the Formula?**
+ * - The file is read and parsed only once, whatever the thread count
+ * - The clause store is immutable and never copied, so sharing it is safe
+ * - Solver setup and the first solve run in parallel in the worker threads
  * - Each thread operates on an independent solver instance
  *
- * **Work Partitioning:**
- * - Variables are divided into N equal-sized ranges
- * - Each thread processes variables [start, end] independently
- * - Static partitioning (no work stealing) for predictable performance
- * - Example with 1000 variables, 4 threads:
- *   - Thread 1: variables 1-250
- *   - Thread 2: variables 251-500
- *   - Thread 3: variables 501-750
- *   - Thread 4: variables 751-1000
+ * **Work Distribution:**
+ * - Per-variable cost is very skewed, so work is distributed dynamically
+ * - Threads claim consecutive chunks of the processing order from a shared
+ *   atomic index; each chunk is a fixed share of the remaining work, so chunks
+ *   shrink to single variables towards the end
+ * - The main thread runs a worker too (on its own solver) and reports progress
+ * - Output does not depend on which thread processed which variable
  *
  * ## Performance Characteristics
  *
@@ -101,6 +97,13 @@
  * **Feature Lists (text files):**
  * - `[basename]__core.txt`: Variables that are always true (positive backbone)
  * - `[basename]__dead.txt`: Variables that are always false (negative backbone)
+ * - `[basename]__atomic_sets.txt`: Sets of equivalent variables (optional, see
+ *   set_write_atomic_sets())
+ *
+ * **Binary Graphs (optional, see set_binary_output()):**
+ * - `[basename]__graphs.csr`: Both graphs as compressed sparse rows with the
+ *   vertex names, laid out to be memory-mapped and queried in place with
+ *   GraphCSR (see GraphCSR.hh); `csr2pajek` converts it back to Pajek
  *
  * ## API Usage
  *
@@ -122,18 +125,20 @@
  * ## Thread Safety
  *
  * **CRITICAL REQUIREMENT:**
- * - BackboneSolverAPI instances MUST be created and initialized in the main thread
- * - NEVER initialize solvers inside worker threads
- * - Each thread must receive a fully initialized solver instance
- * - Violating this causes race conditions and undefined behavior
+ * - Each thread must use its own BackboneSolverAPI instance
+ * - Instances may be built concurrently; worker instances share the formula of
+ *   the main instance (share_formula()) instead of re-reading the file
+ * - The main instance must not read another file while workers are running
+ * - A Dimacs2GraphsAPI object must not run two generate_graphs() calls at once
  *
  * @see Dimacs2GraphsAPI Main API class for parallel graph generation
- * @see BackboneSolverAPI Underlying backbone detection engine (NOT thread-safe during init)
+ * @see BackboneSolverAPI Underlying backbone detection engine
  */
 
 #ifndef DIMACS2GRAPHS_API_HH
 #define DIMACS2GRAPHS_API_HH
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -166,11 +171,18 @@ public:
      *
      * @param dimacs_file Path to the input DIMACS file (with or without .dimacs extension)
      * @param output_folder Optional output folder path (default: same as input file location)
-     * @param detector Backbone detector to use: "one" (default) or "without"
-     *                 - "one": CheckCandidatesOneByOne with activity bumping (recommended)
-     *                 - "without": CheckCandidatesOneByOneWithoutAttention (baseline)
+     * @param detector Backbone detector to use (see BoneDiggerAPI::create_backbone_detector())
+     *                 - "one": CheckCandidatesOneByOne with activity bumping (default, recommended)
+     *                 - "flatland": FastOnCliffsSlowOnPlains
+     *                 - "rush": RushAndPray
+     *                 - "chunk": CheckCandidatesInChunks
+     *                 - "portfolio": the three above, raced on hard variables; each
+     *                   thread keeps two extra racing threads, so it uses three CPUs
      * @param num_of_threads Number of threads to use for parallel processing (default: 1)
-     *                       Must not exceed available CPU cores
+     *                       Times the CPUs per thread of the detector
+     *                       (BoneDiggerAPI::get_detector_threads()), must not
+     *                       exceed get_available_cpus() unless it is 1 or
+     *                       set_oversubscribe(true); 0 uses all of them
      * @return true if successful, false otherwise
      *
      * Output files created:
@@ -178,6 +190,14 @@ public:
      * - `[basename]__excludes.net`  : Pajek format undirected graph (excludes relationships)
      * - `[basename]__core.txt`      : Core features (positive backbone literals)
      * - `[basename]__dead.txt`      : Dead features (negative backbone literals)
+     * - `[basename]__atomic_sets.txt`: Atomic sets (only with set_write_atomic_sets(true))
+     * - `[basename]__graphs.csr`     : Binary CSR graphs (only with set_binary_output(true))
+     * - `[basename]__unknown.txt`    : Undecided edges (only with set_conflict_budget())
+     *
+     * With set_checkpointing(true), `[basename]__checkpoint_<worker>.log` files
+     * exist while the run is in progress (see set_resume()). With
+     * set_report_file(), the JSON run report is written as well. A shard run
+     * (set_shard()) writes only `[basename]__shard_<index>_of_<count>.log`.
      */
     bool generate_graphs(
         const std::string& dimacs_file,
@@ -204,6 +224,18 @@ public:
      */
     std::vector<int> get_global_backbone() const;
 
+    /**
+     * @brief Get the number of variables left incomplete by the conflict budget
+     * @return Variables listed in `[basename]__unknown.txt` by the last run (0 without a budget)
+     */
+    int get_num_unknown_variables() const;
+
+    /**
+     * @brief Get the number of variables whose edges were copied from the previous version
+     * @return Variables reused by the last run (0 without set_previous_version())
+     */
+    int get_num_reused_variables() const;
+
     /**
      * @brief Get the last error message
      * @return Error message string (empty if no error)
@@ -223,6 +255,239 @@ public:
      */
     void set_filter_auxiliary(bool filter);
 
+    /**
+     * @brief Set the capacity of the shared model cache
+     *
+     * Every satisfying assignment found during the analysis is kept (bit-packed,
+     * without duplicates) up to this many models. Before the backbone under v=true
+     * is computed, the candidates already refuted by a cached model with v true are
+     * discarded without calling the SAT solver. Memory use is about
+     * max_models * num_variables / 8 bytes.
+     *
+     * @param max_models Maximum number of cached models (default: 2048, 0 disables the cache)
+     */
+    void set_model_cache_size(int max_models);
+
+    /**
+     * @brief Set whether variables are scheduled bottom-up along requires chains
+     *
+     * Requires edges are transitive: if v implies w, the backbone under w=true is
+     * part of the backbone under v=true. When enabled, variables are processed in
+     * reverse topological order of the binary implication graph of the formula, and
+     * the backbones of already processed successors (plus the global backbone) are
+     * accepted without new UNSAT proofs. The output files are identical either way.
+     *
+     * @param enabled If true, use transitive scheduling (default: true)
+     */
+    void set_transitive_scheduling(bool enabled);
+
+    /**
+     * @brief Set whether equivalent variables share one backbone computation
+     *
+     * Variables that imply each other through chains of binary clauses (e.g. the
+     * parent <=> child pairs of mandatory relations) form atomic sets and have the
+     * same backbone. When enabled, the strongly connected components of the binary
+     * implication graph are computed first, the backbone is computed once per set,
+     * and the edges are expanded back out for every member. The output files are
+     * identical either way.
+     *
+     * @param enabled If true, collapse atomic sets (default: true)
+     */
+    void set_atomic_sets(bool enabled);
+
+    /**
+     * @brief Set whether the atomic sets are written to a file
+     *
+     * When enabled, `[basename]__atomic_sets.txt` lists every atomic set with more
+     * than one variable, one set per line as space-separated variable numbers (in
+     * ascending order). Requires set_atomic_sets(true).
+     *
+     * @param enabled If true, write the atomic sets file (default: false)
+     */
+    void set_write_atomic_sets(bool enabled);
+
+    /**
+     * @brief Set whether the graphs are also written in binary CSR format
+     *
+     * When enabled, `[basename]__graphs.csr` holds a header, the vertex-name
+     * string table and the CSR offset and target arrays of the requires and
+     * excludes graphs (layout in GraphCSR.hh). It is written in addition to the
+     * Pajek files and is meant to be opened with GraphCSR, which maps it and
+     * answers neighbourhood and edge queries without parsing.
+     *
+     * @param enabled If true, write the binary graphs file (default: false)
+     */
+    void set_binary_output(bool enabled);
+
+    /**
+     * @brief Set whether finished variables are checkpointed during the run
+     *
+     * When enabled, every worker appends the edges of the variables it finishes
+     * to `[basename]__checkpoint_<worker>.log` in the output folder, syncing
+     * the log to disk about once per second. The logs are removed once all
+     * output files have been written, so they only remain after a failed or
+     * interrupted run.
+     *
+     * @param enabled If true, write checkpoint logs (default: false)
+     */
+    void set_checkpointing(bool enabled);
+
+    /**
+     * @brief Set whether a previous interrupted run is resumed
+     *
+     * When enabled, the checkpoint logs of the output folder are loaded first
+     * and the variables they contain are not processed again. Logs written for
+     * another formula or with another auxiliary filtering are ignored, as is a
+     * record torn by a crash. Implies set_checkpointing(true). The output is
+     * identical to that of an uninterrupted run.
+     *
+     * @param enabled If true, resume from the checkpoint logs (default: false)
+     */
+    void set_resume(bool enabled);
+
+    /**
+     * @brief Set the file of the JSON run report
+     *
+     * When set, generate_graphs() measures its phases (parse, global backbone,
+     * schedule, variable loop, merge, write), the busy and idle time of every
+     * thread and, for every computed backbone, its wall time, SAT calls split
+     * into SAT and UNSAT answers, conflicts and candidates eliminated by models,
+     * and writes them to this file after the graphs.
+     *
+     * @param path Report file path; empty disables the report (default)
+     */
+    void set_report_file(const std::string& path);
+
+    /**
+     * @brief Set a conflict budget for the backbone of each variable
+     *
+     * Bounds the run time of formulas where a few variables need very hard SAT
+     * calls. When the backbone under v=true runs out of budget, the literals
+     * already proven still give edges in the graphs (every edge written is
+     * certain), and the undecided ones are written to `[basename]__unknown.txt`:
+     * one line per incomplete variable v, followed by the literals whose status
+     * is unknown (w: v possibly requires w; -w: v and w are possibly mutually
+     * exclusive). The global backbone (core and dead features) is never limited.
+     *
+     * With set_checkpointing(true), incomplete variables are not checkpointed
+     * and the logs are kept while any remain, so a run with set_resume(true) and
+     * a larger budget recomputes only the incomplete variables.
+     *
+     * @param conflicts Solver conflicts per variable; negative disables the budget (default)
+     */
+    void set_conflict_budget(int64_t conflicts);
+
+    /**
+     * @brief Refute backbone candidates by flipping them in every model
+     *
+     * After each model, the candidates that can be flipped without falsifying
+     * a clause are refuted without a SAT call, and the rotated model joins the
+     * model cache (model rotation). The graphs are unchanged; only the number
+     * of SAT calls and the time spent on flip tests differ.
+     *
+     * @param enabled true to rotate models (default: false)
+     */
+    void set_model_rotation(bool enabled);
+
+    /**
+     * @brief Set the results of a previous version of the model to start from
+     *
+     * Variability models evolve by small edits, and most relationships survive
+     * them. The previous version is read from `[previous_base].dimacs` and the
+     * graphs and feature lists generated from it (`[previous_base]__requires.net`,
+     * `__excludes.net`, `__core.txt`, `__dead.txt`). Its variables are matched to
+     * the current ones by feature name, and the clauses of both formulas are
+     * compared after renaming:
+     * - The edges of the variables of every connected part of the formula (by
+     *   shared variables) whose clauses did not change are copied, not recomputed.
+     * - If clauses were only added, the old backbone of each recomputed variable
+     *   still holds and is confirmed without SAT calls; if clauses were only
+     *   removed, every literal outside the old backbone is refuted up front.
+     * - Other variables are recomputed as usual.
+     *
+     * The output is identical to that of a run from scratch. Features without a
+     * unique name are never reused. A previous run left incomplete by a
+     * conflict budget (non-empty `[previous_base]__unknown.txt`) is rejected.
+     *
+     * @param previous_base Path of the previous outputs without suffix (the
+     *                      previous DIMACS file without ".dimacs"); empty
+     *                      disables the reuse (default)
+     */
+    void set_previous_version(const std::string& previous_base);
+
+    /**
+     * @brief Restrict the run to one shard of the variables
+     *
+     * Spreads one model over several processes or batch jobs. The schedule
+     * (atomic set representatives in processing order, the same in every run
+     * on the same formula) is cut into count contiguous blocks, and this run
+     * computes block index only. Instead of the graphs and feature lists it
+     * writes the edges of the block to
+     * `[basename]__shard_<index>_of_<count>.log` (checkpoint log format) in the
+     * output folder; a run with set_merge_shards(true) then writes the outputs.
+     *
+     * Shards of one model may run at the same time in the same output folder,
+     * each with its own checkpoints (set_checkpointing()). Variables left
+     * incomplete by a conflict budget are not written to the shard.
+     *
+     * @param index Shard to compute, from 0 to count - 1 (default: 0)
+     * @param count Number of shards; 1 disables sharding (default)
+     */
+    void set_shard(int index, int count);
+
+    /**
+     * @brief Set whether the rows of shard runs are merged
+     *
+     * When enabled, every `[basename]__shard_<index>_of_<count>.log` file of the
+     * output folder is loaded like a checkpoint log, and only the variables
+     * missing from all of them (a shard that failed or was not run) are
+     * computed. Shard files of another formula or auxiliary filtering are
+     * ignored. The output files are those of a single run. The shard files
+     * are not removed.
+     *
+     * @param enabled If true, merge the shard files (default: false)
+     */
+    void set_merge_shards(bool enabled);
+
+    /**
+     * @brief Set whether worker threads are pinned to CPUs
+     *
+     * When enabled, worker t runs only on the (t mod n)-th CPU of the affinity
+     * mask of the process (n CPUs), which keeps its solver's data in that
+     * CPU's caches. The main thread is pinned only while it works. With the
+     * portfolio detector each worker gets three consecutive CPUs of the mask
+     * instead, shared with its racing threads. Linux only; ignored elsewhere.
+     *
+     * @param enabled If true, pin the worker threads (default: false)
+     */
+    void set_pin_threads(bool enabled);
+
+    /**
+     * @brief Set whether more threads than available CPUs may be used
+     *
+     * By default generate_graphs() refuses more threads than
+     * get_available_cpus(), counting three CPUs per thread for the portfolio
+     * detector, whose racing threads run alongside each worker (one thread is
+     * always accepted). SAT search stalls on memory often enough that
+     * running somewhat more threads than CPUs can still pay off, for
+     * instance on SMT cores.
+     *
+     * @param enabled If true, any thread count is accepted (default: false)
+     */
+    void set_oversubscribe(bool enabled);
+
+    /**
+     * @brief Get the number of CPUs this process may use
+     *
+     * Unlike std::thread::hardware_concurrency(), which counts every CPU of
+     * the machine, this counts the CPUs of the affinity mask of the process
+     * (taskset, cpusets) and caps them by its cgroup CPU quota, rounded up
+     * (container CPU limits).
+     *
+     * @return Available CPUs (at least 1)
+     */
+    static int get_available_cpus();
+
 private:
     class Impl;
     Impl* pimpl;
@@ -0,0 +1,429 @@
+/**
+ * @file FeatureQueryAPI.cc
+ * @brief Implementation of FeatureQueryAPI (lazy point queries with caching)
+ *
+ * One BoneDiggerAPI instance holds the formula and two warm solvers: the one
+ * behind solve_with_assumptions() answers check_requires() and
+ * check_excludes() with a single SAT call, and the incremental detector
+ * computes the backbones of implied_by_selection(). Every model either of
+ * them finds reaches the model store through the model callback.
+ *
+ * Answers are looked up in this order, cheapest first:
+ * 1. the answer cache of the query kind
+ * 2. a cached implied_by_selection() of a single literal
+ * 3. the stored models (a model can only disprove a relationship)
+ * 4. the solver
+ *
+ * @see FeatureQueryAPI.hh for the public API interface
+ */
+
+#include "FeatureQueryAPI.hh"
+#include "../../uvl2dimacs/backbone_solver/src/api/BoneDiggerAPI.hh"
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+using namespace std;
+using namespace dimacs2graphs;
+using namespace bonedigger;
+
+class FeatureQueryAPI::Impl {
+public:
+    Impl() {
+        bone.set_model_callback([this](const vector<bool>& model) { store_model(model); });
+    }
+
+    bool load(const string& dimacs_file, const string& detector) {
+        error_message.clear();
+        reset();
+        num_vars = 0;
+
+        if (!bone.read_dimacs(dimacs_file)) {
+            error_message = "Could not read DIMACS file: " + dimacs_file;
+            return false;
+        }
+        if (!bone.create_backbone_detector(detector)) {
+            error_message = "Unknown backbone detector: " + detector;
+            return false;
+        }
+        num_vars = bone.get_max_variable();
+        words_per_model = static_cast<size_t>(num_vars) / 64 + 1;
+        if (!read_feature_names(dimacs_file)) {
+            num_vars = 0;
+            return false;
+        }
+
+        // Loads the point-query solver and stores a first model
+        const bool satisfiable = bone.solve_with_assumptions(vector<int>());
+        stats.sat_calls += bone.get_last_query_stats().solves;
+        if (!satisfiable) {
+            error_message = "Formula is unsatisfiable: " + dimacs_file;
+            num_vars = 0;
+            return false;
+        }
+        return true;
+    }
+
+    int get_num_variables() const { return num_vars; }
+
+    int find_variable(const string& name) const {
+        auto it = name_index.find(name);
+        return it != name_index.end() ? it->second : 0;
+    }
+
+    string get_name(int variable) const {
+        if (variable <= 0 || variable >= static_cast<int>(names.size())) return string();
+        return names[variable];
+    }
+
+    bool check_requires(int a, int b) {
+        error_message.clear();
+        ++stats.queries;
+        if (!check_variable(a) || !check_variable(b)) return false;
+        if (a == b) return true;
+
+        const uint64_t key = pair_key(a, b);
+        auto cached = requires_cache.find(key);
+        if (cached != requires_cache.end()) {
+            ++stats.cache_hits;
+            return cached->second;
+        }
+
+        // a requires b if and only if -b implies -a
+        bool answer;
+        const SelectionResult* implied = find_implied(a);
+        const SelectionResult* contrapositive = find_implied(-b);
+        if (implied != nullptr) {
+            ++stats.cache_hits;
+            answer = !implied->consistent || contains(implied->implied, b);
+        } else if (contrapositive != nullptr) {
+            ++stats.cache_hits;
+            answer = !contrapositive->consistent || contains(contrapositive->implied, -a);
+        } else if (find_model(a, true, b, false)) {
+            ++stats.model_hits;
+            answer = false;
+        } else {
+            answer = !solve({a, -b});
+        }
+        requires_cache.emplace(key, answer);
+        return answer;
+    }
+
+    bool check_excludes(int a, int b) {
+        error_message.clear();
+        ++stats.queries;
+        if (!check_variable(a) || !check_variable(b)) return false;
+
+        // Symmetric: one cache entry per unordered pair
+        const uint64_t key = pair_key(min(a, b), max(a, b));
+        auto cached = excludes_cache.find(key);
+        if (cached != excludes_cache.end()) {
+            ++stats.cache_hits;
+            return cached->second;
+        }
+
+        bool answer;
+        const SelectionResult* implied_a = find_implied(a);
+        const SelectionResult* implied_b = find_implied(b);
+        if (implied_a != nullptr) {
+            ++stats.cache_hits;
+            answer = !implied_a->consistent || (a != b && contains(implied_a->implied, -b));
+        } else if (implied_b != nullptr) {
+            ++stats.cache_hits;
+            answer = !implied_b->consistent || (a != b && contains(implied_b->implied, -a));
+        } else if (find_model(a, true, b, true)) {
+            ++stats.model_hits;
+            answer = false;
+        } else {
+            answer = !solve({a, b});
+        }
+        excludes_cache.emplace(key, answer);
+        return answer;
+    }
+
+    bool implied_by_selection(const vector<int>& selection, vector<int>& implied) {
+        error_message.clear();
+        ++stats.queries;
+        implied.clear();
+
+        // Normalized selection: sorted by variable, no duplicates
+        vector<int> key(selection);
+        for (int lit : key) {
+            if (lit == 0 || !check_variable(abs(lit))) return false;
+        }
+        sort(key.begin(), key.end(), [](int x, int y) {
+            return abs(x) != abs(y) ? abs(x) < abs(y) : x < y;
+        });
+        key.erase(unique(key.begin(), key.end()), key.end());
+
+        auto cached = implied_cache.find(key);
+        if (cached == implied_cache.end()) {
+            SelectionResult result;
+            result.consistent = compute_implied(key, result.implied);
+            cached = implied_cache.emplace(key, move(result)).first;
+        } else {
+            ++stats.cache_hits;
+        }
+
+        if (!cached->second.consistent) {
+            error_message = "Selection is inconsistent with the formula";
+            return false;
+        }
+        implied = cached->second.implied;
+        return true;
+    }
+
+    void set_model_cache_size(int max) {
+        lock_guard<mutex> lock(model_mutex);
+        max_models = max > 0 ? static_cast<size_t>(max) : 0;
+        if (models.size() > max_models) {
+            models.resize(max_models);
+        }
+        next_model = 0;
+    }
+
+    void clear_cache() {
+        requires_cache.clear();
+        excludes_cache.clear();
+        implied_cache.clear();
+        lock_guard<mutex> lock(model_mutex);
+        models.clear();
+        next_model = 0;
+    }
+
+    FeatureQueryAPI::QueryStats get_stats() const { return stats; }
+    string get_error() const { return error_message; }
+
+private:
+    /**
+     * @brief Cached result of implied_by_selection()
+     */
+    struct SelectionResult {
+        bool consistent = false;  ///< Selection satisfiable
+        vector<int> implied;      ///< Implied literals, in increasing variable order
+    };
+
+    void reset() {
+        clear_cache();
+        names.clear();
+        name_index.clear();
+        stats = FeatureQueryAPI::QueryStats();
+    }
+
+    bool check_variable(int variable) {
+        if (variable <= 0 || variable > num_vars) {
+            error_message = "Variable out of range: " + to_string(variable);
+            return false;
+        }
+        return true;
+    }
+
+    static uint64_t pair_key(int a, int b) {
+        return (static_cast<uint64_t>(a) << 32) | static_cast<uint32_t>(b);
+    }
+
+    static bool contains(const vector<int>& literals, int lit) {
+        // Sorted by variable, at most one literal per variable
+        auto it = lower_bound(literals.begin(), literals.end(), lit,
+                              [](int x, int y) { return abs(x) < abs(y); });
+        return it != literals.end() && *it == lit;
+    }
+
+    const SelectionResult* find_implied(int lit) const {
+        auto it = implied_cache.find(vector<int>{lit});
+        return it != implied_cache.end() ? &it->second : nullptr;
+    }
+
+    // One SAT call on the point-query solver
+    bool solve(const vector<int>& assumptions) {
+        const bool satisfiable = bone.solve_with_assumptions(assumptions);
+        stats.sat_calls += bone.get_last_query_stats().solves;
+        return satisfiable;
+    }
+
+    bool compute_implied(const vector<int>& selection, vector<int>& implied) {
+        // Literals false in a stored model of the selection are not implied
+        vector<uint64_t> seen_true(words_per_model, 0);
+        vector<uint64_t> seen_false(words_per_model, 0);
+        bool any_model = false;
+        unique_lock<mutex> lock(model_mutex);
+        for (const vector<uint64_t>& model : models) {
+            bool satisfies = true;
+            for (int lit : selection) {
+                if (bit(model, abs(lit)) != (lit > 0)) {
+                    satisfies = false;
+                    break;
+                }
+            }
+            if (!satisfies) continue;
+            any_model = true;
+            for (size_t w = 0; w < words_per_model; ++w) {
+                seen_true[w] |= model[w];
+                seen_false[w] |= ~model[w];
+            }
+        }
+        lock.unlock();
+        vector<int> refuted;
+        if (any_model) {
+            for (int v = 1; v <= num_vars; ++v) {
+                if (bit(seen_true, v)) refuted.push_back(-v);
+                if (bit(seen_false, v)) refuted.push_back(v);
+            }
+        }
+
+        // Literals implied by a single selected literal are implied by the selection
+        vector<int> confirmed;
+        for (int lit : selection) {
+            const SelectionResult* single = find_implied(lit);
+            if (single != nullptr && single->consistent) {
+                confirmed.insert(confirmed.end(), single->implied.begin(), single->implied.end());
+            }
+        }
+
+        vector<int> backbone;
+        const bool consistent = bone.compute_backbone_with_assumptions(selection, refuted, confirmed, backbone);
+        stats.sat_calls += bone.get_last_query_stats().solves;
+        ++stats.backbone_queries;
+        if (!consistent) return false;
+
+        for (int lit : backbone) {
+            if (!binary_search(selection.begin(), selection.end(), lit,
+                               [](int x, int y) { return abs(x) != abs(y) ? abs(x) < abs(y) : x < y; })) {
+                implied.push_back(lit);
+            }
+        }
+        return true;
+    }
+
+    static bool bit(const vector<uint64_t>& words, int v) {
+        return (words[static_cast<size_t>(v) >> 6] >> (v & 63)) & 1;
+    }
+
+    // Looks for a stored model with variable a set to value_a and b to value_b
+    bool find_model(int a, bool value_a, int b, bool value_b) const {
+        lock_guard<mutex> lock(model_mutex);
+        for (const vector<uint64_t>& model : models) {
+            if (bit(model, a) == value_a && bit(model, b) == value_b) return true;
+        }
+        return false;
+    }
+
+    // Model callback: keeps the newest max_models models. The portfolio
+    // detector calls it from its racing threads, possibly concurrently.
+    void store_model(const vector<bool>& model) {
+        if (num_vars == 0) return;
+        vector<uint64_t> words(words_per_model, 0);
+        const int limit = min(num_vars + 1, static_cast<int>(model.size()));
+        for (int v = 1; v < limit; ++v) {
+            if (model[v]) words[static_cast<size_t>(v) >> 6] |= uint64_t(1) << (v & 63);
+        }
+        lock_guard<mutex> lock(model_mutex);
+        if (max_models == 0) return;
+        if (models.size() < max_models) {
+            models.push_back(move(words));
+        } else {
+            models[next_model] = move(words);
+            next_model = (next_model + 1) % max_models;
+        }
+    }
+
+    // Parses "c [var_num] [feature_name]" comment lines, as Dimacs2GraphsAPI does
+    bool read_feature_names(const string& dimacs_file) {
+        ifstream dimacs(dimacs_file);
+        if (!dimacs.is_open()) {
+            error_message = "Could not open file: " + dimacs_file;
+            return false;
+        }
+        names.assign(num_vars + 1, string());
+        string line;
+        while (getline(dimacs, line)) {
+            if (line.empty() || line[0] != 'c') continue;
+            stringstream ss(line);
+            char c;
+            int variable;
+            string word;
+            string name;
+            if (!(ss >> c >> variable)) continue;
+            while (ss >> word) {
+                if (!name.empty()) name += ' ';
+                name += word;
+            }
+            if (name.empty() || variable <= 0 || variable > num_vars) continue;
+            names[variable] = name;
+        }
+        for (int v = 1; v <= num_vars; ++v) {
+            if (!names[v].empty()) name_index[names[v]] = v;
+        }
+        return true;
+    }
+
+    BoneDiggerAPI bone;  // Formula and warm solvers
+    int num_vars = 0;
+    size_t words_per_model = 1;
+    vector<string> names;
+    unordered_map<string, int> name_index;
+    unordered_map<uint64_t, bool> requires_cache;
+    unordered_map<uint64_t, bool> excludes_cache;
+    map<vector<int>, SelectionResult> implied_cache;
+    vector<vector<uint64_t>> models;  // Bit per variable
+    size_t max_models = 1024;
+    size_t next_model = 0;            // Slot replaced next once the store is full
+    mutable mutex model_mutex;        // Guards the model store (see store_model())
+    FeatureQueryAPI::QueryStats stats;
+    string error_message;
+};
+
+// FeatureQueryAPI implementation
+
+FeatureQueryAPI::FeatureQueryAPI() : pimpl(new Impl()) {}
+
+FeatureQueryAPI::~FeatureQueryAPI() {
+    delete pimpl;
+}
+
+bool FeatureQueryAPI::load(const string& dimacs_file, const string& detector) {
+    return pimpl->load(dimacs_file, detector);
+}
+
+int FeatureQueryAPI::get_num_variables() const {
+    return pimpl->get_num_variables();
+}
+
+int FeatureQueryAPI::find_variable(const string& name) const {
+    return pimpl->find_variable(name);
+}
+
+string FeatureQueryAPI::get_name(int variable) const {
+    return pimpl->get_name(variable);
+}
+
+bool FeatureQueryAPI::check_requires(int a, int b) {
+    return pimpl->check_requires(a, b);
+}
+
+bool FeatureQueryAPI::check_excludes(int a, int b) {
+    return pimpl->check_excludes(a, b);
+}
+
+bool FeatureQueryAPI::implied_by_selection(const vector<int>& selection, vector<int>& implied) {
+    return pimpl->implied_by_selection(selection, implied);
+}
+
+void FeatureQueryAPI::set_model_cache_size(int max_models) {
+    pimpl->set_model_cache_size(max_models);
+}
+
+void FeatureQueryAPI::clear_cache() {
+    pimpl->clear_cache();
+}
+
+FeatureQueryAPI::QueryStats FeatureQueryAPI::get_stats() const {
+    return pimpl->get_stats();
+}
+
+string FeatureQueryAPI::get_error_message() const {
+    return pimpl->get_error();
+}
@@ -0,0 +1,190 @@
+/*
+ *  FeatureQueryAPI.hh
+ *
+ *  On-demand queries of single feature relationships (requires, excludes,
+ *  implications of a partial selection) without generating the graphs.
+ */
+
+/**
+ * @file FeatureQueryAPI.hh
+ * @brief Lazy point queries on a DIMACS formula
+ *
+ * ## Overview
+ *
+ * Dimacs2GraphsAPI::generate_graphs() computes the backbone of every variable
+ * and writes the complete graphs. Interactive tools (a configurator, for
+ * instance) usually need a handful of relationships instead. FeatureQueryAPI
+ * loads the formula once and answers each question on demand:
+ *
+ * | Query                        | Answer is true iff                          | SAT work               |
+ * |------------------------------|---------------------------------------------|------------------------|
+ * | check_requires(a, b)         | formula ∧ a ∧ ¬b is unsatisfiable           | at most one call       |
+ * | check_excludes(a, b)         | formula ∧ a ∧ b is unsatisfiable            | at most one call       |
+ * | implied_by_selection(lits)   | (returns the backbone under lits)           | one backbone query     |
+ *
+ * The solvers stay loaded between queries, so learnt clauses carry over and
+ * no query pays for parsing or solver setup again.
+ *
+ * ## Caching
+ *
+ * - Every answer is cached, so repeating a question costs a lookup.
+ * - Every model found (by a point query or by a backbone query) is kept in a
+ *   bounded store. A model selecting a but not b proves that a does not
+ *   require b; a model selecting a and b proves that they are not exclusive.
+ *   Such questions are answered without any SAT call.
+ * - The models that satisfy a selection refute backbone candidates before
+ *   implied_by_selection() starts its backbone query.
+ * - A cached implied_by_selection({a}) answers check_requires(a, b) and
+ *   check_excludes(a, b) for every b (and implied_by_selection({-b}) answers
+ *   check_requires(a, b) for every a).
+ *
+ * ## Semantics
+ *
+ * Answers are exact logical relationships of the formula. They differ from
+ * the edges of the generated graphs only for core and dead features, which
+ * the graphs leave out: a dead feature vacuously requires and excludes
+ * everything, and every feature requires the core features.
+ *
+ * ## Usage
+ *
+ * ```cpp
+ * dimacs2graphs::FeatureQueryAPI query;
+ * if (!query.load("model.dimacs")) {
+ *     std::cerr << query.get_error_message() << std::endl;
+ *     return 1;
+ * }
+ * int a = query.find_variable("Encryption");
+ * int b = query.find_variable("Network");
+ * if (query.check_requires(a, b)) std::cout << "Encryption requires Network" << std::endl;
+ *
+ * std::vector<int> implied;
+ * if (query.implied_by_selection({a, -b}, implied)) { ... }  // else: invalid selection
+ * ```
+ *
+ * @note Not thread-safe: an instance must be used by one thread at a time.
+ *
+ * @see Dimacs2GraphsAPI for the complete graphs
+ */
+
+#ifndef FEATURE_QUERY_API_HH
+#define FEATURE_QUERY_API_HH
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dimacs2graphs {
+
+/**
+ * @class FeatureQueryAPI
+ * @brief Answers feature relationship queries on demand, with caching
+ */
+class FeatureQueryAPI {
+public:
+    /**
+     * @brief Work counters, accumulated since load()
+     */
+    struct QueryStats {
+        uint64_t queries = 0;           ///< Questions asked
+        uint64_t cache_hits = 0;        ///< Answered from a cached answer
+        uint64_t model_hits = 0;        ///< Answered by a stored model
+        uint64_t sat_calls = 0;         ///< SAT calls (point queries and backbone queries)
+        uint64_t backbone_queries = 0;  ///< implied_by_selection() computations
+    };
+
+    FeatureQueryAPI();
+    ~FeatureQueryAPI();
+
+    FeatureQueryAPI(const FeatureQueryAPI&) = delete;
+    FeatureQueryAPI& operator=(const FeatureQueryAPI&) = delete;
+
+    /**
+     * @brief Load a DIMACS file and check that it is satisfiable
+     *
+     * Reads the clauses and the feature names ("c [var_num] [feature_name]"
+     * comment lines). Clears every cache of a previously loaded formula.
+     *
+     * @param dimacs_file Path to the DIMACS CNF file
+     * @param detector Backbone detector for implied_by_selection()
+     *                 ("one", "flatland", "rush", "chunk" or "portfolio")
+     * @return true if successful, false if the file cannot be read, the
+     *         detector is unknown or the formula is unsatisfiable
+     */
+    bool load(const std::string& dimacs_file, const std::string& detector = "one");
+
+    /// @return Highest variable number of the loaded formula (0 if none)
+    int get_num_variables() const;
+
+    /**
+     * @brief Look up a variable by feature name
+     * @return Variable number, or 0 if no variable has that name
+     */
+    int find_variable(const std::string& name) const;
+
+    /**
+     * @brief Feature name of a variable
+     * @return Name, or an empty string if the variable has no name
+     */
+    std::string get_name(int variable) const;
+
+    /**
+     * @brief Does selecting a force selecting b?
+     *
+     * @param a Variable number
+     * @param b Variable number
+     * @return true if every configuration that selects a also selects b;
+     *         false otherwise or if a variable is out of range (see get_error_message())
+     */
+    bool check_requires(int a, int b);
+
+    /**
+     * @brief Are a and b mutually exclusive?
+     *
+     * @param a Variable number
+     * @param b Variable number
+     * @return true if no configuration selects both a and b;
+     *         false otherwise or if a variable is out of range (see get_error_message())
+     */
+    bool check_excludes(int a, int b);
+
+    /**
+     * @brief Literals forced by a partial selection
+     *
+     * @param selection Selected (positive) and deselected (negative) variables
+     * @param implied Output: literals that hold in every configuration
+     *                consistent with the selection, excluding the selection
+     *                itself, in increasing variable order
+     * @return true if the selection is consistent with the formula; false if
+     *         it is not or a literal is out of range (see get_error_message())
+     */
+    bool implied_by_selection(const std::vector<int>& selection, std::vector<int>& implied);
+
+    /**
+     * @brief Set the maximum number of stored models
+     *
+     * When the store is full the oldest model is replaced. A value of 0
+     * disables model reuse. Default is 1024.
+     *
+     * @param max_models Maximum number of models kept
+     */
+    void set_model_cache_size(int max_models);
+
+    /**
+     * @brief Forget the cached answers and stored models (the solvers stay loaded)
+     */
+    void clear_cache();
+
+    /// @return Work counters since load()
+    QueryStats get_stats() const;
+
+    /// @return Last error message (empty if no error)
+    std::string get_error_message() const;
+
+private:
+    class Impl;
+    Impl* pimpl;
+};
+
+} // namespace dimacs2graphs
+
+#endif // FEATURE_QUERY_API_HH
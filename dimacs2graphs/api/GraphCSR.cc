@@ -0,0 +1,255 @@
+/**
+ * @file GraphCSR.cc
+ * @brief Implementation of the GraphCSR reader for `[basename]__graphs.csr`
+ *
+ * The file is mapped read-only with mmap(); open() validates the header and
+ * that every section lies inside the mapping, so the queries only do pointer
+ * arithmetic on the mapped arrays.
+ *
+ * @see GraphCSR.hh for the file layout
+ */
+
+#include "GraphCSR.hh"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <vector>
+
+using namespace std;
+using namespace dimacs2graphs;
+
+GraphCSR::GraphCSR() : data(nullptr), size(0), header(nullptr) {}
+
+GraphCSR::~GraphCSR() {
+    close();
+}
+
+void GraphCSR::close() {
+    if (data != nullptr) {
+        munmap(const_cast<char*>(data), size);
+    }
+    data = nullptr;
+    size = 0;
+    header = nullptr;
+}
+
+bool GraphCSR::open(const string& path) {
+    close();
+    error_message.clear();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error_message = "Could not open file: " + path;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(CSRHeader))) {
+        ::close(fd);
+        error_message = "Not a graphs file (too small): " + path;
+        return false;
+    }
+    void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        error_message = "Could not map file: " + path;
+        return false;
+    }
+    data = static_cast<const char*>(mapping);
+    size = static_cast<size_t>(st.st_size);
+
+    const CSRHeader* h = reinterpret_cast<const CSRHeader*>(data);
+    if (memcmp(h->magic, CSR_MAGIC, sizeof(CSR_MAGIC)) != 0) {
+        error_message = "Not a graphs file (bad signature): " + path;
+    } else if (h->byte_order != CSR_BYTE_ORDER) {
+        error_message = "Graphs file was written with another byte order: " + path;
+    } else if (h->version != CSR_VERSION) {
+        error_message = "Unsupported graphs file version " + to_string(h->version) + ": " + path;
+    } else if (h->file_size != size) {
+        error_message = "Truncated graphs file: " + path;
+    } else if (h->requires_edges > size / sizeof(uint32_t) ||
+               h->excludes_edges > size / sizeof(uint32_t) / 2) {
+        // Checked before the section sizes below are multiplied out
+        error_message = "Corrupt graphs file (edge counts exceed file size): " + path;
+    }
+
+    // Every section must lie inside the file and be aligned for its type
+    const uint64_t rows = static_cast<uint64_t>(h->num_variables) + 2;
+    struct Section { uint64_t offset; uint64_t bytes; uint64_t align; };
+    const Section sections[] = {
+        {h->names_offset, uint64_t(h->num_names) * sizeof(CSRName), alignof(CSRName)},
+        {h->name_index_offset, (rows - 1) * sizeof(uint32_t), alignof(uint32_t)},
+        {h->strings_offset, h->strings_size, 1},
+        {h->requires_offsets_offset, rows * sizeof(uint64_t), alignof(uint64_t)},
+        {h->requires_targets_offset, h->requires_edges * sizeof(uint32_t), alignof(uint32_t)},
+        {h->excludes_offsets_offset, rows * sizeof(uint64_t), alignof(uint64_t)},
+        {h->excludes_targets_offset, 2 * h->excludes_edges * sizeof(uint32_t), alignof(uint32_t)},
+    };
+    for (const Section& s : sections) {
+        if (!error_message.empty()) break;
+        if (s.offset > size || s.bytes > size - s.offset || s.offset % s.align != 0) {
+            error_message = "Corrupt graphs file (section out of bounds): " + path;
+        }
+    }
+    if (error_message.empty()) {
+        const uint64_t* req = reinterpret_cast<const uint64_t*>(data + h->requires_offsets_offset);
+        const uint64_t* exc = reinterpret_cast<const uint64_t*>(data + h->excludes_offsets_offset);
+        if (req[rows - 1] != h->requires_edges || exc[rows - 1] != 2 * h->excludes_edges) {
+            error_message = "Corrupt graphs file (edge counts do not match): " + path;
+        }
+        // row() trusts the offsets, so every row must stay inside its targets section
+        for (uint64_t v = 0; v + 1 < rows && error_message.empty(); ++v) {
+            if (req[v] > req[v + 1] || exc[v] > exc[v + 1]) {
+                error_message = "Corrupt graphs file (row offsets not increasing): " + path;
+            }
+        }
+    }
+    if (!error_message.empty()) {
+        close();
+        return false;
+    }
+
+    header = h;
+    return true;
+}
+
+uint32_t GraphCSR::get_num_variables() const {
+    return header ? header->num_variables : 0;
+}
+
+uint32_t GraphCSR::get_vertex_count() const {
+    return header ? header->vertex_count : 0;
+}
+
+uint64_t GraphCSR::get_num_requires_edges() const {
+    return header ? header->requires_edges : 0;
+}
+
+uint64_t GraphCSR::get_num_excludes_edges() const {
+    return header ? header->excludes_edges : 0;
+}
+
+GraphCSR::Targets GraphCSR::row(uint64_t offsets_offset, uint64_t targets_offset, int v) const {
+    Targets targets;
+    if (!header || v < 0 || static_cast<uint32_t>(v) > header->num_variables) {
+        return targets;
+    }
+    const uint64_t* offsets = reinterpret_cast<const uint64_t*>(data + offsets_offset);
+    const uint32_t* base = reinterpret_cast<const uint32_t*>(data + targets_offset);
+    targets.first = base + offsets[v];
+    targets.last = base + offsets[v + 1];
+    return targets;
+}
+
+GraphCSR::Targets GraphCSR::requires_targets(int v) const {
+    return header ? row(header->requires_offsets_offset, header->requires_targets_offset, v)
+                  : Targets();
+}
+
+GraphCSR::Targets GraphCSR::excludes_targets(int v) const {
+    return header ? row(header->excludes_offsets_offset, header->excludes_targets_offset, v)
+                  : Targets();
+}
+
+bool GraphCSR::has_requires(int a, int b) const {
+    Targets targets = requires_targets(a);
+    return b >= 0 && binary_search(targets.begin(), targets.end(), static_cast<uint32_t>(b));
+}
+
+bool GraphCSR::has_excludes(int a, int b) const {
+    Targets targets = excludes_targets(a);
+    return b >= 0 && binary_search(targets.begin(), targets.end(), static_cast<uint32_t>(b));
+}
+
+uint32_t GraphCSR::get_num_names() const {
+    return header ? header->num_names : 0;
+}
+
+uint32_t GraphCSR::name_variable(uint32_t i) const {
+    if (!header || i >= header->num_names) return 0;
+    return reinterpret_cast<const CSRName*>(data + header->names_offset)[i].variable;
+}
+
+string_view GraphCSR::name_at(uint32_t i) const {
+    if (!header || i >= header->num_names) return string_view();
+    const CSRName& entry = reinterpret_cast<const CSRName*>(data + header->names_offset)[i];
+    if (entry.offset > header->strings_size || entry.length > header->strings_size - entry.offset) {
+        return string_view();
+    }
+    return string_view(data + header->strings_offset + entry.offset, entry.length);
+}
+
+string_view GraphCSR::name(int v) const {
+    if (!header || v < 0 || static_cast<uint32_t>(v) > header->num_variables) return string_view();
+    const uint32_t* index = reinterpret_cast<const uint32_t*>(data + header->name_index_offset);
+    return index[v] == CSR_NO_NAME ? string_view() : name_at(index[v]);
+}
+
+/**
+ * @brief Writes one Pajek file in the format of Dimacs2GraphsAPI
+ *
+ * Vertex lines quote every word of the name separately; excludes edges are
+ * written once, from the smaller endpoint.
+ */
+bool GraphCSR::write_pajek_file(const string& path, bool requires_graph) {
+    ofstream out(path, ios::binary);
+    if (!out.is_open()) {
+        error_message = "Could not create output file: " + path;
+        return false;
+    }
+
+    out << "*Vertices " << header->vertex_count << "\n";
+    for (uint32_t i = 0; i < header->num_names; i++) {
+        string_view rest = name_at(i);
+        out << name_variable(i);
+        while (!rest.empty()) {
+            size_t space = rest.find(' ');
+            out << " \"" << rest.substr(0, space) << "\"";
+            rest = space == string_view::npos ? string_view() : rest.substr(space + 1);
+        }
+        out << "\n";
+    }
+    out << (requires_graph ? "*Arcs\n" : "*Edges\n");
+
+    vector<char> buffer(1 << 16);
+    const size_t max_line = 24;  // Two 32-bit numbers, a space and a newline
+    size_t used = 0;
+    for (uint32_t v = 1; v <= header->num_variables; v++) {
+        Targets targets = requires_graph ? requires_targets(v) : excludes_targets(v);
+        for (uint32_t target : targets) {
+            if (!requires_graph && target <= v) continue;
+            if (buffer.size() - used < max_line) {
+                out.write(buffer.data(), used);
+                used = 0;
+            }
+            char* line = buffer.data() + used;
+            char* p = to_chars(line, line + max_line, v).ptr;
+            *p++ = ' ';
+            p = to_chars(p, line + max_line, target).ptr;
+            *p++ = '\n';
+            used = p - buffer.data();
+        }
+    }
+    out.write(buffer.data(), used);
+    out << "\n";
+
+    if (!out) {
+        error_message = "Could not write output file: " + path;
+        return false;
+    }
+    return true;
+}
+
+bool GraphCSR::write_pajek(const string& output_base) {
+    error_message.clear();
+    if (!header) {
+        error_message = "No graphs file is open";
+        return false;
+    }
+    return write_pajek_file(output_base + "__requires.net", true) &&
+           write_pajek_file(output_base + "__excludes.net", false);
+}
@@ -0,0 +1,228 @@
+/*
+ *  GraphCSR.hh
+ *
+ *  Binary, memory-mappable representation of the requires and excludes graphs
+ *  (compressed sparse rows) and a zero-copy reader for it.
+ */
+
+/**
+ * @file GraphCSR.hh
+ * @brief Layout of `[basename]__graphs.csr` and the GraphCSR reader
+ *
+ * ## File Layout
+ *
+ * All integers use the byte order of the host that wrote the file (checked
+ * through CSRHeader::byte_order). Every section starts at an 8-byte aligned
+ * offset, so the arrays can be used in place once the file is mapped.
+ *
+ * | Section           | Type                          | Count                   |
+ * |-------------------|-------------------------------|-------------------------|
+ * | Header            | CSRHeader                     | 1                       |
+ * | Vertex names      | CSRName (Pajek vertex order)  | num_names               |
+ * | Name index        | uint32_t (entry of each var)  | num_variables + 1       |
+ * | Name strings      | char (not NUL-terminated)     | strings_size            |
+ * | Requires offsets  | uint64_t                      | num_variables + 2       |
+ * | Requires targets  | uint32_t                      | requires_edges          |
+ * | Excludes offsets  | uint64_t                      | num_variables + 2       |
+ * | Excludes targets  | uint32_t                      | 2 * excludes_edges      |
+ *
+ * Rows are indexed by variable number (row 0 is always empty): the targets of
+ * variable v are `targets[offsets[v] .. offsets[v + 1])`, in ascending order.
+ * The excludes graph is undirected and stored symmetrically, so every edge
+ * appears in the rows of both endpoints.
+ *
+ * ## Usage
+ *
+ * ```cpp
+ * dimacs2graphs::GraphCSR graphs;
+ * if (!graphs.open("model__graphs.csr")) {
+ *     std::cerr << graphs.get_error_message() << std::endl;
+ *     return 1;
+ * }
+ * for (uint32_t target : graphs.requires_targets(42)) {
+ *     std::cout << graphs.name(42) << " requires " << graphs.name(target) << std::endl;
+ * }
+ * ```
+ *
+ * @see Dimacs2GraphsAPI::set_binary_output() to write the file
+ */
+
+#ifndef GRAPH_CSR_HH
+#define GRAPH_CSR_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace dimacs2graphs {
+
+/// File signature of `[basename]__graphs.csr`
+constexpr char CSR_MAGIC[8] = {'S', '4', 'V', 'M', 'C', 'S', 'R', '\0'};
+/// Current version of the layout
+constexpr uint32_t CSR_VERSION = 1;
+/// Written as is; reads back differently on a host with another byte order
+constexpr uint32_t CSR_BYTE_ORDER = 0x01020304;
+/// Name index value of a variable without a vertex name
+constexpr uint32_t CSR_NO_NAME = UINT32_MAX;
+
+/**
+ * @brief Fixed-size header at offset 0
+ *
+ * Section offsets are in bytes from the start of the file.
+ */
+struct CSRHeader {
+    char magic[8];                     ///< CSR_MAGIC
+    uint32_t version;                  ///< CSR_VERSION
+    uint32_t byte_order;               ///< CSR_BYTE_ORDER
+    uint32_t num_variables;            ///< Highest variable number
+    uint32_t vertex_count;             ///< Vertex count of the Pajek files
+    uint32_t num_names;                ///< Number of CSRName entries
+    uint32_t reserved;                 ///< Zero
+    uint64_t requires_edges;           ///< Number of arcs of the requires graph
+    uint64_t excludes_edges;           ///< Number of edges of the excludes graph
+    uint64_t names_offset;             ///< CSRName[num_names]
+    uint64_t name_index_offset;        ///< uint32_t[num_variables + 1]
+    uint64_t strings_offset;           ///< char[strings_size]
+    uint64_t strings_size;             ///< Size of the string data
+    uint64_t requires_offsets_offset;  ///< uint64_t[num_variables + 2]
+    uint64_t requires_targets_offset;  ///< uint32_t[requires_edges]
+    uint64_t excludes_offsets_offset;  ///< uint64_t[num_variables + 2]
+    uint64_t excludes_targets_offset;  ///< uint32_t[2 * excludes_edges]
+    uint64_t file_size;                ///< Total size of the file
+};
+
+/**
+ * @brief Vertex name entry
+ *
+ * A name is the feature name of the DIMACS comment line; words are separated
+ * by single spaces.
+ */
+struct CSRName {
+    uint32_t variable;  ///< Variable number
+    uint32_t length;    ///< Name length in bytes
+    uint64_t offset;    ///< Start of the name in the string data
+};
+
+static_assert(sizeof(CSRHeader) == 120, "CSRHeader layout changed");
+static_assert(sizeof(CSRName) == 16, "CSRName layout changed");
+
+/**
+ * @class GraphCSR
+ * @brief Read-only view of a `[basename]__graphs.csr` file
+ *
+ * open() maps the file and checks the header, the section bounds and that the
+ * row offsets never decrease; queries then read straight from the mapping
+ * without copying. Target values are trusted as written by Dimacs2GraphsAPI.
+ *
+ * @note Not copyable. Views returned by the queries are valid until close().
+ */
+class GraphCSR {
+public:
+    /**
+     * @brief Contiguous range of target variables
+     */
+    struct Targets {
+        const uint32_t* first = nullptr;
+        const uint32_t* last = nullptr;
+
+        const uint32_t* begin() const { return first; }
+        const uint32_t* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        bool empty() const { return first == last; }
+        uint32_t operator[](size_t i) const { return first[i]; }
+    };
+
+    GraphCSR();
+    ~GraphCSR();
+
+    GraphCSR(const GraphCSR&) = delete;
+    GraphCSR& operator=(const GraphCSR&) = delete;
+
+    /**
+     * @brief Map a graphs file
+     * @param path Path to `[basename]__graphs.csr`
+     * @return true if successful, false otherwise (see get_error_message())
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Unmap the file (called by the destructor)
+     */
+    void close();
+
+    /// @return true if a file is mapped
+    bool is_open() const { return header != nullptr; }
+
+    /// @return Highest variable number (0 if no file is mapped)
+    uint32_t get_num_variables() const;
+
+    /// @return Vertex count of the equivalent Pajek files
+    uint32_t get_vertex_count() const;
+
+    /// @return Number of arcs of the requires graph
+    uint64_t get_num_requires_edges() const;
+
+    /// @return Number of (undirected) edges of the excludes graph
+    uint64_t get_num_excludes_edges() const;
+
+    /**
+     * @brief Variables required by v (arcs v -> target)
+     * @param v Variable number; out-of-range values give an empty range
+     */
+    Targets requires_targets(int v) const;
+
+    /**
+     * @brief Variables mutually exclusive with v
+     * @param v Variable number; out-of-range values give an empty range
+     */
+    Targets excludes_targets(int v) const;
+
+    /// @return true if selecting a requires b (binary search)
+    bool has_requires(int a, int b) const;
+
+    /// @return true if a and b are mutually exclusive (binary search)
+    bool has_excludes(int a, int b) const;
+
+    /**
+     * @brief Feature name of variable v
+     * @return Name, or an empty view if v has no name
+     */
+    std::string_view name(int v) const;
+
+    /// @return Number of named vertices
+    uint32_t get_num_names() const;
+
+    /// @return Variable of the i-th named vertex (Pajek vertex order)
+    uint32_t name_variable(uint32_t i) const;
+
+    /// @return Name of the i-th named vertex (Pajek vertex order)
+    std::string_view name_at(uint32_t i) const;
+
+    /**
+     * @brief Write the equivalent Pajek files
+     *
+     * Produces `[output_base]__requires.net` and `[output_base]__excludes.net`,
+     * byte-identical to the ones written by Dimacs2GraphsAPI.
+     *
+     * @param output_base Output path without the `__requires.net` suffix
+     * @return true if successful, false otherwise (see get_error_message())
+     */
+    bool write_pajek(const std::string& output_base);
+
+    /// @return Last error message (empty if no error)
+    std::string get_error_message() const { return error_message; }
+
+private:
+    Targets row(uint64_t offsets_offset, uint64_t targets_offset, int v) const;
+    bool write_pajek_file(const std::string& path, bool requires_graph);
+
+    const char* data;
+    size_t size;
+    const CSRHeader* header;
+    std::string error_message;
+};
+
+} // namespace dimacs2graphs
+
+#endif // GRAPH_CSR_HH
@@ -0,0 +1,57 @@
+/*
+ *  csr2pajek.cc
+ *  Command-line converter from the binary CSR graphs to Pajek
+ *
+ *  Input: [basename]__graphs.csr (written with Dimacs2GraphsAPI::set_binary_output)
+ *  Output: [basename]__requires.net and [basename]__excludes.net
+ *
+ */
+
+#include "../api/GraphCSR.hh"
+#include <iostream>
+#include <string>
+
+using namespace std;
+using namespace dimacs2graphs;
+
+int main(int argc, char **argv) {
+	if (argc < 2 || argc > 3) {
+		cout << "Convert binary CSR graphs to Pajek." << endl;
+		cout << endl;
+		cout << "USAGE: ./csr2pajek <graphs_file> [output_base]" << endl;
+		cout << "  graphs_file  - Path to a [basename]__graphs.csr file" << endl;
+		cout << "  output_base  - Output path prefix (default: graphs_file without __graphs.csr)" << endl;
+		return 1;
+	}
+
+	string csr_file(argv[1]);
+	string output_base;
+	if (argc == 3) {
+		output_base = argv[2];
+	} else {
+		const string suffix = "__graphs.csr";
+		output_base = csr_file;
+		if (output_base.size() > suffix.size() &&
+		    output_base.compare(output_base.size() - suffix.size(), suffix.size(), suffix) == 0) {
+			output_base.resize(output_base.size() - suffix.size());
+		}
+	}
+
+	GraphCSR graphs;
+	if (!graphs.open(csr_file)) {
+		cerr << "Error: " << graphs.get_error_message() << endl;
+		return 2;
+	}
+
+	cout << "Vertices: " << graphs.get_vertex_count()
+	     << ", requires arcs: " << graphs.get_num_requires_edges()
+	     << ", excludes edges: " << graphs.get_num_excludes_edges() << endl;
+	cout << "Saving to " << output_base << "__requires.net" << endl;
+	cout << "Saving to " << output_base << "__excludes.net" << endl;
+	if (!graphs.write_pajek(output_base)) {
+		cerr << "Error: " << graphs.get_error_message() << endl;
+		return 2;
+	}
+
+	return 0;
+}
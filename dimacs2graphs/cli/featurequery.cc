@@ -0,0 +1,120 @@
+/*
+ *  featurequery.cc
+ *  Command-line front end of FeatureQueryAPI
+ *
+ *  Input: Satisfiable formula (Read from file, first arg) and one query per
+ *         line on standard input
+ *  Output: One answer per query on standard output
+ *
+ */
+
+#include "../api/FeatureQueryAPI.hh"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace dimacs2graphs;
+
+// Variable of a feature given by number or by (single-word) name; 0 if unknown
+static int parse_variable(const FeatureQueryAPI& query, const string& token) {
+	char* end = nullptr;
+	const long number = strtol(token.c_str(), &end, 10);
+	if (!token.empty() && *end == '\0') {
+		return number > 0 && number <= query.get_num_variables() ? static_cast<int>(number) : 0;
+	}
+	return query.find_variable(token);
+}
+
+static string literal_name(const FeatureQueryAPI& query, int lit) {
+	const int variable = lit > 0 ? lit : -lit;
+	const string name = query.get_name(variable);
+	const string label = name.empty() ? to_string(variable) : name;
+	return lit > 0 ? label : "-" + label;
+}
+
+int main(int argc, char **argv) {
+	if (argc < 2 || argc > 3) {
+		cout << "Answer feature relationship queries on a CNF SAT formula." << endl;
+		cout << endl;
+		cout << "USAGE: ./featurequery <dimacs_file> [detector]" << endl;
+		cout << "  dimacs_file  - Path to the DIMACS file" << endl;
+		cout << "  detector     - Backbone detector: one, flatland, rush, chunk, portfolio (default: one)" << endl;
+		cout << endl;
+		cout << "Queries (one per line on standard input; features by number or name):" << endl;
+		cout << "  requires A B       - Does selecting A force selecting B?" << endl;
+		cout << "  excludes A B       - Are A and B mutually exclusive?" << endl;
+		cout << "  implied L1 L2 ...  - Literals forced by a selection (-F deselects F)" << endl;
+		cout << "  stats              - Cache and solver counters" << endl;
+		return 1;
+	}
+
+	FeatureQueryAPI query;
+	const string detector = argc == 3 ? argv[2] : "one";
+	if (!query.load(argv[1], detector)) {
+		cerr << "Error: " << query.get_error_message() << endl;
+		return 2;
+	}
+
+	string line;
+	while (getline(cin, line)) {
+		istringstream ss(line);
+		string command;
+		if (!(ss >> command)) continue;
+		vector<string> args;
+		string arg;
+		while (ss >> arg) args.push_back(arg);
+
+		const auto start = chrono::steady_clock::now();
+		if ((command == "requires" || command == "excludes") && args.size() == 2) {
+			const int a = parse_variable(query, args[0]);
+			const int b = parse_variable(query, args[1]);
+			if (a == 0 || b == 0) {
+				cout << "error: unknown feature" << endl;
+				continue;
+			}
+			const bool answer = command == "requires" ? query.check_requires(a, b)
+			                                          : query.check_excludes(a, b);
+			cout << (answer ? "yes" : "no");
+		} else if (command == "implied" && !args.empty()) {
+			vector<int> selection;
+			for (const string& token : args) {
+				const bool negated = token.size() > 1 && token[0] == '-' &&
+				                     parse_variable(query, token) == 0;
+				const int variable = parse_variable(query, negated ? token.substr(1) : token);
+				if (variable == 0) {
+					selection.clear();
+					break;
+				}
+				selection.push_back(negated ? -variable : variable);
+			}
+			if (selection.empty()) {
+				cout << "error: unknown feature" << endl;
+				continue;
+			}
+			vector<int> implied;
+			if (!query.implied_by_selection(selection, implied)) {
+				cout << "error: " << query.get_error_message() << endl;
+				continue;
+			}
+			cout << implied.size() << ":";
+			for (int lit : implied) cout << " " << literal_name(query, lit);
+		} else if (command == "stats") {
+			const FeatureQueryAPI::QueryStats stats = query.get_stats();
+			cout << "queries=" << stats.queries << " cache_hits=" << stats.cache_hits
+			     << " model_hits=" << stats.model_hits << " sat_calls=" << stats.sat_calls
+			     << " backbone_queries=" << stats.backbone_queries << endl;
+			continue;
+		} else {
+			cout << "error: unknown query" << endl;
+			continue;
+		}
+		const chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+		cout << " (" << elapsed.count() << " ms)" << endl;
+	}
+
+	return 0;
+}
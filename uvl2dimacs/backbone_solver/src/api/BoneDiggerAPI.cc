@@ -8,13 +8,19 @@
 
 #include "BoneDiggerAPI.hh"
 #include "DIMACSReader.hh"
+#include "CheckCandidatesInChunks.hh"
 #include "CheckCandidatesOneByOne.hh"
 #include "FastOnCliffsSlowOnPlains.hh"
 #include "RushAndPray.hh"
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <iomanip>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <thread>
 
 using std::cout;
 using std::cerr;
@@ -25,14 +31,20 @@ namespace bonedigger {
 // Private implementation class (PIMPL pattern)
 class BoneDiggerAPI::Impl {
 public:
+    // Portfolio: one incremental detector per algorithm (ONE, FLATLAND, RUSH),
+    // each run in its own thread when raced
+    static constexpr int PORTFOLIO_SIZE = 3;
+
     Impl() : max_id(0), detector(nullptr), has_file(false), is_sat(false), attention_weight(1.0) {}
 
     ~Impl() {
+        cleanup_incremental_detector();
         cleanup_detector();
         cleanup_reader();
     }
 
     bool read_file(const string& file_name) {
+        cleanup_incremental_detector();
         cleanup_detector();
         cleanup_reader();
 
@@ -50,7 +62,7 @@ public:
 
             // Store the data
             max_id = dimacs_reader.get_max_id();
-            clauses = dimacs_reader.get_clause_vector();
+            clauses = std::make_shared<const CNF>(dimacs_reader.get_clause_vector());
             has_file = true;
             is_sat = false;
 
@@ -61,6 +73,23 @@ public:
         }
     }
 
+    bool share_file(const Impl& source) {
+        if (!source.has_file) {
+            return false;
+        }
+
+        cleanup_incremental_detector();
+        cleanup_detector();
+        cleanup_reader();
+
+        max_id = source.max_id;
+        clauses = source.clauses;
+        has_file = true;
+        is_sat = false;
+
+        return true;
+    }
+
     bool create_detector(const string& type) {
         if (!has_file) {
             return false;
@@ -74,6 +103,10 @@ public:
             detector_type = FLATLAND;
         } else if (type == "rush" || type == "rushandpray") {
             detector_type = RUSH;
+        } else if (type == "chunk") {
+            detector_type = CHUNK;
+        } else if (type == "portfolio") {
+            detector_type = PORTFOLIO;
         } else {
             return false;
         }
@@ -83,26 +116,46 @@ public:
 
     vector<int> compute() {
         vector<int> result;
+        last_stats = BoneDiggerAPI::QueryStats();
 
         if (!has_file || detector_type == NONE) {
             return result;
         }
 
+        // The portfolio keeps its own detectors; the global backbone is never limited
+        if (detector_type == PORTFOLIO) {
+            assumption_literals.clear();
+            refuted_literals.clear();
+            confirmed_literals.clear();
+            try {
+                is_sat = compute_portfolio(-1, portfolio_backbone);
+            } catch (...) {
+                cleanup_portfolio();
+                portfolio_backbone.clear();
+                is_sat = false;
+            }
+            return portfolio_backbone;
+        }
+
         // Only cleanup if detector hasn't been created yet
         if (detector == nullptr) {
             try {
                 if (detector_type == ONE) {
-                    CheckCandidatesOneByOne* one_detector = new CheckCandidatesOneByOne(max_id, clauses, attention_weight);
+                    CheckCandidatesOneByOne* one_detector = new CheckCandidatesOneByOne(max_id, *clauses, attention_weight);
                     detector = one_detector;
+                    one_detector->set_model_observer(make_model_observer());
+                    one_detector->set_model_rotation(model_rotation);
 
                     if (!one_detector->initialize()) {
                         is_sat = false;
+                        record_stats(one_detector->get_stats());
                         cleanup_detector();
                         return result;
                     }
 
                     is_sat = true;
                     one_detector->run();
+                    record_stats(one_detector->get_stats());
 
                     // Extract backbone
                     for (Var v = 1; v <= max_id; ++v) {
@@ -114,17 +167,21 @@ public:
 
                 } else if (detector_type == FLATLAND) {
                     FastOnCliffsSlowOnPlains* flatland_detector =
-                        new FastOnCliffsSlowOnPlains(max_id, clauses, attention_weight);
+                        new FastOnCliffsSlowOnPlains(max_id, *clauses, attention_weight);
                     detector = flatland_detector;
+                    flatland_detector->set_model_observer(make_model_observer());
+                    flatland_detector->set_model_rotation(model_rotation);
 
                     if (!flatland_detector->initialize()) {
                         is_sat = false;
+                        record_stats(flatland_detector->get_stats());
                         cleanup_detector();
                         return result;
                     }
 
                     is_sat = true;
                     flatland_detector->run();
+                    record_stats(flatland_detector->get_stats());
 
                     // Extract backbone
                     for (Var v = 1; v <= max_id; ++v) {
@@ -136,17 +193,21 @@ public:
 
                 } else if (detector_type == RUSH) {
                     RushAndPray* rush_detector =
-                        new RushAndPray(max_id, clauses, attention_weight);
+                        new RushAndPray(max_id, *clauses, attention_weight);
                     detector = rush_detector;
+                    rush_detector->set_model_observer(make_model_observer());
+                    rush_detector->set_model_rotation(model_rotation);
 
                     if (!rush_detector->initialize()) {
                         is_sat = false;
+                        record_stats(rush_detector->get_stats());
                         cleanup_detector();
                         return result;
                     }
 
                     is_sat = true;
                     rush_detector->run();
+                    record_stats(rush_detector->get_stats());
 
                     // Extract backbone
                     for (Var v = 1; v <= max_id; ++v) {
@@ -156,6 +217,32 @@ public:
                         }
                     }
 
+                } else if (detector_type == CHUNK) {
+                    CheckCandidatesInChunks* chunk_detector =
+                        new CheckCandidatesInChunks(max_id, *clauses, attention_weight);
+                    detector = chunk_detector;
+                    chunk_detector->set_model_observer(make_model_observer());
+                    chunk_detector->set_model_rotation(model_rotation);
+
+                    if (!chunk_detector->initialize()) {
+                        is_sat = false;
+                        record_stats(chunk_detector->get_stats());
+                        cleanup_detector();
+                        return result;
+                    }
+
+                    is_sat = true;
+                    chunk_detector->run();
+                    record_stats(chunk_detector->get_stats());
+
+                    // Extract backbone
+                    for (Var v = 1; v <= max_id; ++v) {
+                        if (chunk_detector->is_backbone(v)) {
+                            int lit = chunk_detector->backbone_sign(v) ? v : -v;
+                            result.push_back(lit);
+                        }
+                    }
+
                 }
             } catch (...) {
                 cleanup_detector();
@@ -190,6 +277,15 @@ public:
                             result.push_back(lit);
                         }
                     }
+                } else if (detector_type == CHUNK) {
+                    CheckCandidatesInChunks* chunk_detector =
+                        static_cast<CheckCandidatesInChunks*>(detector);
+                    for (Var v = 1; v <= max_id; ++v) {
+                        if (chunk_detector->is_backbone(v)) {
+                            int lit = chunk_detector->backbone_sign(v) ? v : -v;
+                            result.push_back(lit);
+                        }
+                    }
                 }
             } catch (...) {
                 return vector<int>();
@@ -199,49 +295,166 @@ public:
         return result;
     }
     
-    vector<int> compute_with_assumptions(const vector<int>& assumptions) {
-        if (!has_file) return {};
+    bool compute_with_assumptions(const vector<int>& assumptions,
+                                  const vector<int>& refuted,
+                                  const vector<int>& confirmed,
+                                  vector<int>& result) {
+        result.clear();
+        last_stats = BoneDiggerAPI::QueryStats();
+        unknown_literals.clear();
+        if (!has_file) return false;
 
-        // Build a modified CNF by adding assumption unit clauses
-        CNF modified_clauses = clauses;
         for (int assump : assumptions) {
-            Var var = (Var)(std::abs(assump));  // MiniSat vars are 1-indexed here, matching DIMACS
-            bool sign = (assump < 0);           // true = negative literal in MiniSat
-            LiteralVector unit;
-            unit.push_back(mkLit(var, sign));
-            modified_clauses.push_back(LitSet(unit));
+            if (assump == 0 || std::abs(assump) > max_id) return false;
+        }
+        for (int lit : refuted) {
+            if (lit == 0 || std::abs(lit) > max_id) return false;
+        }
+        for (int lit : confirmed) {
+            if (lit == 0 || std::abs(lit) > max_id) return false;
+        }
+
+        if (detector_type == PORTFOLIO) {
+            to_literals(assumptions, assumption_literals);
+            to_literals(refuted, refuted_literals);
+            to_literals(confirmed, confirmed_literals);
+            try {
+                return compute_portfolio(conflict_budget, result);
+            } catch (...) {
+                cleanup_portfolio();
+                result.clear();
+                return false;
+            }
+        }
+
+        if (!incremental) {
+            return compute_with_fresh_detector(assumptions, refuted, confirmed, result);
         }
 
         // Use the configured detector type; fall back to ONE if not yet set
-        DetectorType fresh_type = (detector_type != NONE) ? detector_type : ONE;
-        BackBone* det = nullptr;
+        DetectorType query_type = (detector_type != NONE) ? detector_type : ONE;
+        if (incremental_detector == nullptr || incremental_type != query_type) {
+            cleanup_incremental_detector();
+            try {
+                if      (query_type == ONE)      incremental_detector = new CheckCandidatesOneByOne(max_id, *clauses, attention_weight);
+                else if (query_type == FLATLAND) incremental_detector = new FastOnCliffsSlowOnPlains(max_id, *clauses, attention_weight);
+                else if (query_type == RUSH)     incremental_detector = new RushAndPray(max_id, *clauses, attention_weight);
+                else if (query_type == CHUNK)    incremental_detector = new CheckCandidatesInChunks(max_id, *clauses, attention_weight);
+                else return false;
+            } catch (...) {
+                return false;
+            }
+            incremental_detector->set_model_observer(make_model_observer());
+            incremental_type = query_type;
+        }
+
+        // The assumptions go to the solver, which keeps the formula and its
+        // learnt clauses from one call to the next
+        to_literals(assumptions, assumption_literals);
+        to_literals(refuted, refuted_literals);
+        to_literals(confirmed, confirmed_literals);
+
+        const DetectorStats before = incremental_detector->get_stats();
+        incremental_detector->set_conflict_budget(conflict_budget);
+        incremental_detector->set_model_rotation(model_rotation);
         try {
-            if      (fresh_type == ONE)      det = new CheckCandidatesOneByOne(max_id, modified_clauses, attention_weight);
-            else if (fresh_type == FLATLAND) det = new FastOnCliffsSlowOnPlains(max_id, modified_clauses, attention_weight);
-            else if (fresh_type == RUSH)     det = new RushAndPray(max_id, modified_clauses, attention_weight);
-            else return {};
+            const bool satisfiable = incremental_detector->initialize(assumption_literals);
+            if (satisfiable) {
+                incremental_detector->refute(refuted_literals);
+                incremental_detector->confirm(confirmed_literals);
+                incremental_detector->run();
+                incremental_detector->get_unknown(unknown_literals);
+            }
+            record_stats(incremental_detector->get_stats(), before);
+            if (!satisfiable) return false;
+            for (Var v = 1; v <= max_id; ++v) {
+                if (incremental_detector->is_backbone(v))
+                    result.push_back(incremental_detector->backbone_sign(v) ? (int)v : -(int)v);
+            }
         } catch (...) {
-            return {};
+            cleanup_incremental_detector();
+            result.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool solve_assumptions(const vector<int>& assumptions) {
+        last_stats = BoneDiggerAPI::QueryStats();
+        unknown_literals.clear();
+        if (!has_file) return false;
+
+        for (int assump : assumptions) {
+            if (assump == 0 || std::abs(assump) > max_id) return false;
         }
 
-        vector<int> result;
         try {
-            if (det->initialize()) {
-                det->run();
-                for (Var v = 1; v <= max_id; ++v) {
-                    if (det->is_backbone(v))
-                        result.push_back(det->backbone_sign(v) ? (int)v : -(int)v);
+            // Loaded once; its learnt clauses help the following calls
+            if (query_solver == nullptr) {
+                query_solver = new MiniSatExt();
+                query_observer = make_model_observer();
+                for (Var i = 0; i <= max_id; ++i) {
+                    query_solver->newVar();
+                }
+                vec<Lit> ls;
+                for (const LitSet& clause : *clauses) {
+                    ls.clear();
+                    for (auto li = clause.begin(); li != clause.end(); ++li) {
+                        ls.push(*li);
+                    }
+                    if (!query_solver->addClause(ls)) break;
                 }
             }
-        } catch (...) {}
 
-        delete det;
-        return result;
+            to_literals(assumptions, assumption_literals);
+            const uint64_t conflicts_before = query_solver->conflicts;
+            const bool satisfiable = query_solver->solve(assumption_literals);
+            last_stats.solves = 1;
+            last_stats.conflicts = query_solver->conflicts - conflicts_before;
+            if (satisfiable) {
+                last_stats.models = 1;
+                query_observer(query_solver->model);
+            }
+            return satisfiable;
+        } catch (...) {
+            cleanup_query_solver();
+            return false;
+        }
     }
 
-    void set_weight(double w) { attention_weight = w; }
+    void set_weight(double w) {
+        attention_weight = w;
+        cleanup_incremental_detector();
+    }
+    void set_incremental_mode(bool enabled) { incremental = enabled; }
+    void set_budget(int64_t conflicts) { conflict_budget = conflicts; }
+    void set_rotation(bool enabled) { model_rotation = enabled; }
+    bool get_last_complete() const { return unknown_literals.size() == 0; }
+
+    void get_unknown(vector<int>& unknown) const {
+        unknown.clear();
+        for (int i = 0; i < unknown_literals.size(); ++i) {
+            const Lit l = unknown_literals[i];
+            unknown.push_back(sign(l) ? -(int)var(l) : (int)var(l));
+        }
+    }
+    void set_callback(BoneDiggerAPI::ModelCallback callback) { model_callback = callback; }
     int get_max_var() const { return max_id; }
+
+    vector<std::pair<int, int>> get_binaries() const {
+        vector<std::pair<int, int>> binaries;
+        if (!clauses) return binaries;
+        for (const LitSet& clause : *clauses) {
+            if (clause.size() != 2) continue;
+            const Lit a = clause[0];
+            const Lit b = clause[1];
+            binaries.emplace_back(sign(a) ? -var(a) : var(a), sign(b) ? -var(b) : var(b));
+        }
+        return binaries;
+    }
     bool get_is_sat() const { return is_sat; }
+    BoneDiggerAPI::QueryStats get_last_stats() const { return last_stats; }
     
     void print_bb() const {
         if (!is_sat) {
@@ -257,14 +470,16 @@ public:
         // Print formula statistics
         cout << "Formula statistics:" << endl;
         cout << "  Variables: " << max_id << endl;
-        cout << "  Clauses: " << clauses.size() << endl;
+        cout << "  Clauses: " << clauses->size() << endl;
         cout << "Formula is SATISFIABLE" << endl;
         
         // Count and collect backbone literals
         vector<int> backbone_lits;
 
         try {
-            if (detector_type == ONE) {
+            if (detector_type == PORTFOLIO) {
+                backbone_lits = portfolio_backbone;
+            } else if (detector_type == ONE) {
                 CheckCandidatesOneByOne* one_detector = static_cast<CheckCandidatesOneByOne*>(detector);
                 if (one_detector) {
                     for (Var v = 1; v <= max_id; ++v) {
@@ -296,6 +511,17 @@ public:
                         }
                     }
                 }
+            } else if (detector_type == CHUNK) {
+                CheckCandidatesInChunks* chunk_detector =
+                    static_cast<CheckCandidatesInChunks*>(detector);
+                if (chunk_detector) {
+                    for (Var v = 1; v <= max_id; ++v) {
+                        if (chunk_detector->is_backbone(v)) {
+                            int lit = chunk_detector->backbone_sign(v) ? v : -v;
+                            backbone_lits.push_back(lit);
+                        }
+                    }
+                }
             }
         } catch (...) {
             cout << "Error retrieving backbone" << endl;
@@ -318,7 +544,268 @@ public:
     }
     
 private:
-    enum DetectorType { NONE, ONE, FLATLAND, RUSH };
+    enum DetectorType { NONE, ONE, FLATLAND, RUSH, CHUNK, PORTFOLIO };
+
+    // Conflicts the leading detector gets alone before a query is raced
+    static constexpr int64_t PORTFOLIO_HEAD_START = 1000;
+    enum RaceStatus { RACE_UNSAT, RACE_COMPLETE, RACE_INCOMPLETE };
+
+    // Runs the current query (the scratch literal buffers) on one detector
+    RaceStatus run_racer(BackBone* racer, int64_t budget) {
+        racer->set_conflict_budget(budget);
+        racer->set_model_rotation(model_rotation);
+        if (!racer->initialize(assumption_literals)) return RACE_UNSAT;
+        racer->refute(refuted_literals);
+        racer->confirm(confirmed_literals);
+        racer->run();
+        return racer->is_complete() ? RACE_COMPLETE : RACE_INCOMPLETE;
+    }
+
+    // Body of a racing thread: waits for a race, runs its racer on it, and
+    // reports back. The threads live as long as the portfolio, so hard
+    // queries do not pay for thread creation.
+    void race_loop(int slot) {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(race_mutex);
+        while (true) {
+            race_start.wait(lock, [this, seen] { return race_stop || race_round != seen; });
+            if (race_stop) return;
+            seen = race_round;
+            const int racer = race_jobs[slot];
+            lock.unlock();
+            race_task(racer);
+            lock.lock();
+            if (--race_pending == 0) race_done.notify_one();
+        }
+    }
+
+    // Runs task(i) for every racer but the leader in the racing threads,
+    // task(lead) in the calling one, and returns once all of them are done.
+    // The threads are started on the first race and inherit the CPU affinity
+    // of the thread that runs it.
+    void run_race(int lead, const std::function<void(int)>& task) {
+        if (!race_threads[0].joinable()) {
+            race_stop = false;
+            for (int slot = 0; slot < PORTFOLIO_SIZE - 1; ++slot) {
+                race_threads[slot] = std::thread(&Impl::race_loop, this, slot);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(race_mutex);
+            int slot = 0;
+            for (int i = 0; i < PORTFOLIO_SIZE; ++i) {
+                if (i != lead) race_jobs[slot++] = i;
+            }
+            race_task = task;
+            race_pending = PORTFOLIO_SIZE - 1;
+            ++race_round;
+        }
+        race_start.notify_all();
+        task(lead);
+        std::unique_lock<std::mutex> lock(race_mutex);
+        race_done.wait(lock, [this] { return race_pending == 0; });
+        race_task = nullptr;
+    }
+
+    void stop_race_threads() {
+        {
+            std::lock_guard<std::mutex> lock(race_mutex);
+            race_stop = true;
+        }
+        race_start.notify_all();
+        for (auto& thread : race_threads) {
+            if (thread.joinable()) thread.join();
+        }
+    }
+
+    // Portfolio query. The detector that has won most races so far gets a
+    // head start alone; easy queries end there without any thread. Otherwise
+    // all the detectors race on the query, the leader in the calling thread
+    // and the others in the racing threads, and the first to decide every
+    // candidate interrupts the others. Results are exact whoever wins; with
+    // a budget and no winner, the leader's partial result is kept.
+    bool compute_portfolio(int64_t budget, vector<int>& result) {
+        result.clear();
+        if (racers[0] == nullptr) {
+            racers[0] = new CheckCandidatesOneByOne(max_id, *clauses, attention_weight);
+            racers[1] = new FastOnCliffsSlowOnPlains(max_id, *clauses, attention_weight);
+            racers[2] = new RushAndPray(max_id, *clauses, attention_weight);
+            for (int i = 0; i < PORTFOLIO_SIZE; ++i) {
+                racers[i]->set_model_observer(make_model_observer(racer_buffers[i]));
+            }
+        }
+
+        int lead = 0;
+        for (int i = 1; i < PORTFOLIO_SIZE; ++i) {
+            if (racer_wins[i] > racer_wins[lead]) lead = i;
+        }
+        DetectorStats before[PORTFOLIO_SIZE];
+        for (int i = 0; i < PORTFOLIO_SIZE; ++i) {
+            before[i] = racers[i]->get_stats();
+        }
+
+        const bool head_start_only = budget >= 0 && budget <= PORTFOLIO_HEAD_START;
+        RaceStatus status[PORTFOLIO_SIZE];
+        status[lead] = run_racer(racers[lead], head_start_only ? budget : PORTFOLIO_HEAD_START);
+        int winner = lead;
+
+        if (status[lead] == RACE_INCOMPLETE && !head_start_only) {
+            std::atomic<int> first(-1);
+            auto race = [this, budget, &status, &first](int i) {
+                try {
+                    status[i] = run_racer(racers[i], budget);
+                } catch (...) {
+                    status[i] = RACE_INCOMPLETE;
+                }
+                int none = -1;
+                if (status[i] != RACE_INCOMPLETE && first.compare_exchange_strong(none, i)) {
+                    for (int j = 0; j < PORTFOLIO_SIZE; ++j) {
+                        if (j != i) racers[j]->interrupt();
+                    }
+                }
+            };
+            run_race(lead, race);
+            for (int i = 0; i < PORTFOLIO_SIZE; ++i) {
+                racers[i]->clear_interrupt();
+            }
+            if (first >= 0) {
+                winner = first;
+                ++racer_wins[winner];
+            }
+        }
+
+        // The work of every detector counts, winners and losers alike
+        last_stats = BoneDiggerAPI::QueryStats();
+        for (int i = 0; i < PORTFOLIO_SIZE; ++i) {
+            const DetectorStats after = racers[i]->get_stats();
+            last_stats.solves += after.solves - before[i].solves;
+            last_stats.models += after.models - before[i].models;
+            last_stats.interrupted += after.interrupted - before[i].interrupted;
+            last_stats.conflicts += after.conflicts - before[i].conflicts;
+            last_stats.eliminated_by_models += after.eliminated_by_models - before[i].eliminated_by_models;
+            last_stats.refuted += after.refuted - before[i].refuted;
+            last_stats.confirmed += after.confirmed - before[i].confirmed;
+        }
+
+        if (status[winner] == RACE_UNSAT) return false;
+        BackBone* det = racers[winner];
+        det->get_unknown(unknown_literals);
+        for (Var v = 1; v <= max_id; ++v) {
+            if (det->is_backbone(v))
+                result.push_back(det->backbone_sign(v) ? (int)v : -(int)v);
+        }
+        return true;
+    }
+
+    void cleanup_portfolio() {
+        stop_race_threads();
+        for (int i = 0; i < PORTFOLIO_SIZE; ++i) {
+            delete racers[i];
+            racers[i] = nullptr;
+            racer_wins[i] = 0;
+        }
+    }
+
+    // Non-incremental path: runs a fresh detector (and solver) on the
+    // formula under the assumptions. The clauses are never copied, since
+    // LitSet reference counts must not change while the store is shared.
+    bool compute_with_fresh_detector(const vector<int>& assumptions,
+                                     const vector<int>& refuted,
+                                     const vector<int>& confirmed,
+                                     vector<int>& result) {
+
+        // Use the configured detector type; fall back to ONE if not yet set
+        DetectorType fresh_type = (detector_type != NONE) ? detector_type : ONE;
+        BackBone* det = nullptr;
+        try {
+            if      (fresh_type == ONE)      det = new CheckCandidatesOneByOne(max_id, *clauses, attention_weight);
+            else if (fresh_type == FLATLAND) det = new FastOnCliffsSlowOnPlains(max_id, *clauses, attention_weight);
+            else if (fresh_type == RUSH)     det = new RushAndPray(max_id, *clauses, attention_weight);
+            else if (fresh_type == CHUNK)    det = new CheckCandidatesInChunks(max_id, *clauses, attention_weight);
+            else return false;
+        } catch (...) {
+            return false;
+        }
+
+        det->set_model_observer(make_model_observer());
+        det->set_model_rotation(model_rotation);
+        det->set_conflict_budget(conflict_budget);
+        to_literals(assumptions, assumption_literals);
+        to_literals(refuted, refuted_literals);
+        to_literals(confirmed, confirmed_literals);
+
+        bool satisfiable = false;
+        try {
+            if (det->initialize(assumption_literals)) {
+                det->refute(refuted_literals);
+                det->confirm(confirmed_literals);
+                det->run();
+                det->get_unknown(unknown_literals);
+                for (Var v = 1; v <= max_id; ++v) {
+                    if (det->is_backbone(v))
+                        result.push_back(det->backbone_sign(v) ? (int)v : -(int)v);
+                }
+                satisfiable = true;
+            }
+            record_stats(det->get_stats());
+        } catch (...) {
+            result.clear();
+        }
+
+        delete det;
+        return satisfiable;
+    }
+
+    // Stores the work of the last query (difference of two detector snapshots)
+    void record_stats(const DetectorStats& after, const DetectorStats& before = DetectorStats()) {
+        last_stats.solves = after.solves - before.solves;
+        last_stats.models = after.models - before.models;
+        last_stats.interrupted = after.interrupted - before.interrupted;
+        last_stats.conflicts = after.conflicts - before.conflicts;
+        last_stats.eliminated_by_models = after.eliminated_by_models - before.eliminated_by_models;
+        last_stats.refuted = after.refuted - before.refuted;
+        last_stats.confirmed = after.confirmed - before.confirmed;
+    }
+
+    // Converts DIMACS literals into solver literals
+    static void to_literals(const vector<int>& dimacs_literals, vec<Lit>& literals) {
+        literals.clear();
+        for (int lit : dimacs_literals) {
+            literals.push(mkLit((Var)(std::abs(lit)), lit < 0));
+        }
+    }
+
+    // Observer handed to every detector; translates solver models for the
+    // user callback (looked up at call time, so it may be set at any point).
+    // Detectors running concurrently need a buffer each.
+    ModelObserver make_model_observer(vector<bool>& buffer) {
+        return [this, &buffer](const vec<lbool>& model) {
+            if (!model_callback) return;
+            buffer.assign(max_id + 1, false);
+            const int limit = std::min((int)max_id + 1, model.size());
+            for (Var v = 1; v < limit; ++v) {
+                buffer[v] = (model[v] == l_True);
+            }
+            model_callback(buffer);
+        };
+    }
+
+    ModelObserver make_model_observer() {
+        return make_model_observer(model_buffer);
+    }
+
+    void cleanup_incremental_detector() {
+        delete incremental_detector;
+        incremental_detector = nullptr;
+        incremental_type = NONE;
+        cleanup_portfolio();
+        cleanup_query_solver();
+    }
+
+    void cleanup_query_solver() {
+        delete query_solver;
+        query_solver = nullptr;
+    }
 
     void cleanup_detector() {
         if (detector) {
@@ -328,6 +815,8 @@ private:
                 delete static_cast<FastOnCliffsSlowOnPlains*>(detector);
             } else if (detector_type == RUSH) {
                 delete static_cast<RushAndPray*>(detector);
+            } else if (detector_type == CHUNK) {
+                delete static_cast<CheckCandidatesInChunks*>(detector);
             }
             detector = nullptr;
         }
@@ -339,16 +828,43 @@ private:
             delete reader;
             reader = nullptr;
         }
-        clauses.clear();
+        clauses.reset();
         max_id = 0;
         has_file = false;
     }
     
     Reader* reader = nullptr;
     Var max_id;
-    CNF clauses;
+    std::shared_ptr<const CNF> clauses;  // Immutable, possibly shared with other instances
     void* detector;
     DetectorType detector_type = NONE;
+    BackBone* incremental_detector = nullptr;  // Reused by compute_with_assumptions()
+    DetectorType incremental_type = NONE;
+    MiniSatExt* query_solver = nullptr;  // Reused by solve_assumptions()
+    ModelObserver query_observer;
+    bool incremental = true;
+    BoneDiggerAPI::ModelCallback model_callback;
+    vector<bool> model_buffer;
+    vec<Lit> assumption_literals;  // Scratch buffers reused across queries
+    vec<Lit> refuted_literals;
+    vec<Lit> confirmed_literals;
+    vec<Lit> unknown_literals;     // Candidates left undecided by the last query
+    int64_t conflict_budget = -1;  // Per query under assumptions, negative for no limit
+    bool model_rotation = false;   // Flip candidates in every model (BackBone::set_model_rotation())
+    BoneDiggerAPI::QueryStats last_stats;  // Work of the last query
+    BackBone* racers[PORTFOLIO_SIZE] = {nullptr, nullptr, nullptr};  // Portfolio detectors
+    vector<bool> racer_buffers[PORTFOLIO_SIZE];  // Model buffer of each portfolio detector
+    uint64_t racer_wins[PORTFOLIO_SIZE] = {0, 0, 0};  // Races won by each one
+    vector<int> portfolio_backbone;  // Result of compute() with the portfolio
+    std::thread race_threads[PORTFOLIO_SIZE - 1];  // Run the racers other than the leader
+    int race_jobs[PORTFOLIO_SIZE - 1] = {0, 0};    // Racer of each racing thread in this race
+    std::function<void(int)> race_task;            // Work of the current race
+    std::mutex race_mutex;                         // Guards the race_* members
+    std::condition_variable race_start;            // A race started (or the threads must stop)
+    std::condition_variable race_done;             // All the racing threads finished
+    uint64_t race_round = 0;                       // Races started so far
+    int race_pending = 0;                          // Racing threads still running this race
+    bool race_stop = false;
     bool has_file;
     bool is_sat;
     double attention_weight;
@@ -366,10 +882,18 @@ bool BoneDiggerAPI::read_dimacs(const string& file_name) {
     return pimpl->read_file(file_name);
 }
 
+bool BoneDiggerAPI::share_formula(const BoneDiggerAPI& source) {
+    return pimpl->share_file(*source.pimpl);
+}
+
 bool BoneDiggerAPI::create_backbone_detector(const string& bb_detector) {
     return pimpl->create_detector(bb_detector);
 }
 
+int BoneDiggerAPI::get_detector_threads(const string& bb_detector) {
+    return bb_detector == "portfolio" ? Impl::PORTFOLIO_SIZE : 1;
+}
+
 vector<int> BoneDiggerAPI::compute_backbone() {
     return pimpl->compute();
 }
@@ -391,7 +915,60 @@ void BoneDiggerAPI::print_backbone() const {
 }
 
 vector<int> BoneDiggerAPI::compute_backbone_with_assumptions(const vector<int>& assumptions) {
-    return pimpl->compute_with_assumptions(assumptions);
+    vector<int> backbone;
+    pimpl->compute_with_assumptions(assumptions, vector<int>(), vector<int>(), backbone);
+    return backbone;
+}
+
+vector<int> BoneDiggerAPI::compute_backbone_with_assumptions(const vector<int>& assumptions,
+                                                             const vector<int>& refuted,
+                                                             const vector<int>& confirmed) {
+    vector<int> backbone;
+    pimpl->compute_with_assumptions(assumptions, refuted, confirmed, backbone);
+    return backbone;
+}
+
+bool BoneDiggerAPI::compute_backbone_with_assumptions(const vector<int>& assumptions,
+                                                      const vector<int>& refuted,
+                                                      const vector<int>& confirmed,
+                                                      vector<int>& backbone) {
+    return pimpl->compute_with_assumptions(assumptions, refuted, confirmed, backbone);
+}
+
+bool BoneDiggerAPI::solve_with_assumptions(const vector<int>& assumptions) {
+    return pimpl->solve_assumptions(assumptions);
+}
+
+vector<std::pair<int, int>> BoneDiggerAPI::get_binary_clauses() const {
+    return pimpl->get_binaries();
+}
+
+void BoneDiggerAPI::set_model_callback(ModelCallback callback) {
+    pimpl->set_callback(callback);
+}
+
+void BoneDiggerAPI::set_incremental(bool enabled) {
+    pimpl->set_incremental_mode(enabled);
+}
+
+void BoneDiggerAPI::set_conflict_budget(int64_t conflicts) {
+    pimpl->set_budget(conflicts);
+}
+
+void BoneDiggerAPI::set_model_rotation(bool enabled) {
+    pimpl->set_rotation(enabled);
+}
+
+bool BoneDiggerAPI::is_last_query_complete() const {
+    return pimpl->get_last_complete();
+}
+
+void BoneDiggerAPI::get_last_unknown(vector<int>& unknown) const {
+    pimpl->get_unknown(unknown);
+}
+
+BoneDiggerAPI::QueryStats BoneDiggerAPI::get_last_query_stats() const {
+    return pimpl->get_last_stats();
 }
 
 } // namespace bonedigger
@@ -12,7 +12,10 @@
 #ifndef BONEDIGGERAPI_HH
 #define BONEDIGGERAPI_HH
 
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <utility>
 #include <vector>
 
 using std::string;
@@ -42,7 +45,7 @@ using std::vector;
  *         return 1;
  *     }
  *
- *     // Create a detector (options: "one", "flatland", "rush")
+ *     // Create a detector (options: "one", "flatland", "rush", "chunk")
  *     if (!api.create_backbone_detector("one")) {
  *         return 1;
  *     }
@@ -73,6 +76,8 @@ using std::vector;
  * - **"rush"** - RushAndPray detector (default, good general purpose)
  * - **"one"** - CheckCandidatesOneByOne (systematic with activity bumping)
  * - **"flatland"** - FastOnCliffsSlowOnPlains (adaptive cliff/plain strategy)
+ * - **"chunk"** - CheckCandidatesInChunks (tests groups of candidates, keeps the unsat core)
+ * - **"portfolio"** - Races the three detectors on hard queries (see create_backbone_detector())
  *
  * ## Building with the API
  *
@@ -95,7 +100,8 @@ using std::vector;
  * ## Thread Safety
  *
  * The BoneDiggerAPI class is NOT thread-safe. Each thread should use its own
- * BoneDiggerAPI instance.
+ * BoneDiggerAPI instance. Instances created with share_formula() read the same
+ * immutable clause store, which is safe.
  *
  * ## Example Program
  *
@@ -129,6 +135,14 @@ namespace bonedigger {
  */
 class BoneDiggerAPI {
 public:
+    /**
+     * @brief Callback receiving the satisfying assignments found by the detectors
+     *
+     * model[v] is true if variable v is true in the assignment (index 0 is unused).
+     * The vector is only valid during the call.
+     */
+    typedef std::function<void(const vector<bool>& model)> ModelCallback;
+
     /**
      * @brief Construct a new BoneDiggerAPI object
      */
@@ -151,6 +165,21 @@ public:
      */
     bool read_dimacs(const string& file_name);
 
+    /**
+     * @brief Use the formula already read by another instance
+     *
+     * Shares the parsed clauses of source instead of reading and parsing the
+     * file again. The clause store is immutable and only read by the detectors,
+     * so several instances (e.g. one per thread) can share it; each of them
+     * still builds its own solver. Sharing must happen before the instances
+     * are used concurrently.
+     *
+     * @param source Instance on which read_dimacs() succeeded
+     * @return true if the formula was shared
+     * @return false if source has no formula
+     */
+    bool share_formula(const BoneDiggerAPI& source);
+
     /**
      * @brief Create a backbone detector for the last read DIMACS file
      *
@@ -161,11 +190,31 @@ public:
      *                    - "one" or "simple": CheckCandidatesOneByOne (fast upper-bound)
      *                    - "flatland": FastOnCliffsSlowOnPlains (adaptive strategy)
      *                    - "rush": RushAndPray (experimental)
+     *                    - "chunk": CheckCandidatesInChunks (adaptive groups of
+     *                      candidates, narrowed with the unsatisfiable core)
+     *                    - "portfolio": the three detectors above. Each query first
+     *                      runs alone on the detector that has won most races so
+     *                      far, for up to 1000 conflicts. If that is not enough, all
+     *                      three race on it, and the first to finish stops the
+     *                      others with Solver::interrupt(). The two extra racing
+     *                      threads are started on the first race and kept until
+     *                      the instance is destroyed, so each instance needs
+     *                      get_detector_threads("portfolio") CPUs. The portfolio
+     *                      always keeps its solvers, whatever set_incremental() says.
      * @return true if detector was successfully created
      * @return false if no DIMACS file has been read or bb_detector is invalid
      */
     bool create_backbone_detector(const string& bb_detector = "simple");
 
+    /**
+     * @brief Number of threads a detector runs its queries on
+     *
+     * @param bb_detector Algorithm name, as for create_backbone_detector()
+     * @return 3 for "portfolio" (the calling thread and two racing threads),
+     *         1 for the other detectors
+     */
+    static int get_detector_threads(const string& bb_detector);
+
     /**
      * @brief Compute the backbone using the created detector
      *
@@ -213,16 +262,180 @@ public:
     /**
      * @brief Compute the backbone under given assumptions
      *
-     * Adds the assumptions as unit clauses to the formula and computes the backbone
-     * of the resulting formula. A fresh detector instance is created for each call.
+     * Computes the backbone of the formula restricted by the assumptions.
+     * In incremental mode (the default) one detector is kept alive across
+     * calls: the formula is loaded into its SAT solver once, the assumptions
+     * are passed as solver assumptions, and learnt clauses are reused by later
+     * calls. With set_incremental(false) a fresh detector (and solver) is
+     * created for each call.
      * Must be called after read_dimacs() and create_backbone_detector().
      *
      * @param assumptions Literals to assume: positive int forces var=true,
      *                    negative int forces var=false (1-indexed DIMACS convention)
      * @return vector<int> Backbone literals under the assumptions, or empty if UNSAT
+     *                     or an assumption refers to an unknown variable
      */
     vector<int> compute_backbone_with_assumptions(const vector<int>& assumptions);
 
+    /**
+     * @brief Compute the backbone under given assumptions, reusing known results
+     *
+     * Same as compute_backbone_with_assumptions(assumptions), but with knowledge
+     * gathered by the caller, so fewer SAT calls are needed:
+     * - refuted literals are known not to be in the backbone (for instance because
+     *   they are false in a model found earlier that satisfies the assumptions) and
+     *   are removed from the candidates;
+     * - confirmed literals are known to be in the backbone (for instance because they
+     *   are in the backbone of a literal implied by the assumptions) and are accepted
+     *   without an UNSAT proof.
+     *
+     * @param assumptions Literals to assume (DIMACS convention)
+     * @param refuted Literals that are false in some model under the assumptions
+     * @param confirmed Literals that hold in every model under the assumptions
+     * @return vector<int> Backbone literals under the assumptions, or empty if UNSAT
+     */
+    vector<int> compute_backbone_with_assumptions(const vector<int>& assumptions,
+                                                  const vector<int>& refuted,
+                                                  const vector<int>& confirmed = vector<int>());
+
+    /**
+     * @brief Compute the backbone under given assumptions into a reusable buffer
+     *
+     * Same as the previous overload, but the backbone literals (in increasing
+     * variable order) are written to backbone, which is cleared first. Passing
+     * the same buffer to every call avoids allocating a result per query.
+     *
+     * @param assumptions Literals to assume (DIMACS convention)
+     * @param refuted Literals that are false in some model under the assumptions
+     * @param confirmed Literals that hold in every model under the assumptions
+     * @param backbone Output: backbone literals under the assumptions
+     * @return true if the formula is satisfiable under the assumptions
+     * @return false if UNSAT or a literal refers to an unknown variable (backbone is empty)
+     */
+    bool compute_backbone_with_assumptions(const vector<int>& assumptions,
+                                           const vector<int>& refuted,
+                                           const vector<int>& confirmed,
+                                           vector<int>& backbone);
+
+    /**
+     * @brief Check satisfiability under given assumptions with one SAT call
+     *
+     * Cheaper than a backbone query when a single relationship is needed; for
+     * instance, a requires b if and only if the formula is unsatisfiable
+     * assuming a and -b. A dedicated solver is loaded on the first call and
+     * kept, with its learnt clauses, for the following ones. A model found
+     * is reported to the model callback (see set_model_callback()). The
+     * conflict budget does not apply.
+     * Must be called after read_dimacs().
+     *
+     * @param assumptions Literals to assume (DIMACS convention)
+     * @return true if the formula is satisfiable under the assumptions
+     * @return false if UNSAT or an assumption refers to an unknown variable
+     */
+    bool solve_with_assumptions(const vector<int>& assumptions);
+
+    /**
+     * @brief Get the binary clauses of the last read formula
+     *
+     * Useful to build the binary implication graph: a clause (a b) means
+     * that -a implies b and -b implies a.
+     *
+     * @return vector<pair<int, int>> Binary clauses in DIMACS convention
+     */
+    vector<std::pair<int, int>> get_binary_clauses() const;
+
+    /**
+     * @brief Register a callback for every model found by the detectors
+     *
+     * The callback is invoked from the thread that runs the computation, for
+     * compute_backbone() as well as compute_backbone_with_assumptions(). With
+     * the "portfolio" detector it is also invoked from the racing threads,
+     * possibly concurrently, so it must then be thread-safe.
+     *
+     * @param callback Callback, or an empty function to disable it
+     */
+    void set_model_callback(ModelCallback callback);
+
+    /**
+     * @brief Enable or disable the incremental assumption mode
+     *
+     * When enabled (default), compute_backbone_with_assumptions() reuses a
+     * single loaded solver for all calls. When disabled, every call rebuilds
+     * the solver from the formula.
+     *
+     * @param enabled true to reuse the solver across calls
+     */
+    void set_incremental(bool enabled);
+
+    /**
+     * @brief Limit the conflicts spent by each query under assumptions
+     *
+     * Bounds the SAT work of compute_backbone_with_assumptions() (the global
+     * compute_backbone() is never limited). When a query runs out of budget it
+     * still returns the backbone literals proven so far, which are exact; the
+     * candidates left undecided are reported by get_last_unknown(). A budget is
+     * counted in solver conflicts, so results do not depend on machine load.
+     *
+     * @param conflicts Conflicts per query, or a negative value for no limit (default)
+     */
+    void set_conflict_budget(int64_t conflicts);
+
+    /**
+     * @brief Refute candidates by flipping them in every model found
+     *
+     * After each model the detectors flip the remaining candidates one after
+     * the other, as long as every clause stays satisfied (model rotation).
+     * Each flipped candidate is refuted without a SAT call, and the rotated
+     * model also goes to the model callback. Results are unchanged. The flip
+     * tests walk the clauses of the candidates, so rotation pays off when SAT
+     * calls are expensive compared with a pass over the formula.
+     *
+     * @param enabled true to rotate models in every detector (default: false)
+     */
+    void set_model_rotation(bool enabled);
+
+    /**
+     * @brief Check whether the last query decided every candidate
+     *
+     * @return false if the conflict budget stopped the last
+     *         compute_backbone_with_assumptions() call early
+     */
+    bool is_last_query_complete() const;
+
+    /**
+     * @brief Get the literals left undecided by the last query
+     *
+     * Each literal may or may not be in the backbone under the assumptions of
+     * the last compute_backbone_with_assumptions() call. Empty when the query
+     * was complete.
+     *
+     * @param unknown Output: undecided literals (DIMACS convention), cleared first
+     */
+    void get_last_unknown(vector<int>& unknown) const;
+
+    /**
+     * @brief Work done by one backbone query
+     */
+    struct QueryStats {
+        uint64_t solves = 0;                ///< SAT calls
+        uint64_t models = 0;                ///< SAT answers (unsatisfiable: solves - models - interrupted)
+        uint64_t interrupted = 0;           ///< SAT calls stopped without an answer (conflict budget or portfolio race)
+        uint64_t conflicts = 0;             ///< Solver conflicts
+        uint64_t eliminated_by_models = 0;  ///< Candidates discarded by models found in the query
+        uint64_t refuted = 0;               ///< Candidates dropped through the refuted literals
+        uint64_t confirmed = 0;             ///< Candidates accepted without an UNSAT proof
+    };
+
+    /**
+     * @brief Get the work done by the last compute_backbone(),
+     *        compute_backbone_with_assumptions() or solve_with_assumptions() call
+     *
+     * The counters are cheap to maintain and always collected.
+     *
+     * @return QueryStats of the last query (all zero before the first one)
+     */
+    QueryStats get_last_query_stats() const;
+
     /**
      * @brief Print the backbone to standard output
      *
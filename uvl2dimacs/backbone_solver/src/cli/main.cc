@@ -12,6 +12,7 @@
 #include <iostream>
 
 #include "BackBone.hh"
+#include "CheckCandidatesInChunks.hh"
 #include "CheckCandidatesOneByOne.hh"
 #include "DIMACSReader.hh"
 #include "FastOnCliffsSlowOnPlains.hh"
@@ -31,12 +32,13 @@ static const char* COLOR_RESET = "\033[0m";
 
 static const char* output_prefix = "c ";
 
-enum DetectorType { RUSH, FLATLAND, ONE_BY_ONE };
+enum DetectorType { RUSH, FLATLAND, ONE_BY_ONE, CHUNKS };
 
 static string input_file_name;
 static bool print_help = false;
 static DetectorType detector_type = RUSH;  // Default to RushAndPray
 static double attention_weight = 1.0;
+static bool model_rotation = false;
 static BackBone* pdetector = NULL;
 static Range range;
 static bool instance_sat = false;
@@ -91,6 +93,8 @@ BackBone* create_detector(DetectorType type, Var max_id, const CNF& clauses, dou
       return new FastOnCliffsSlowOnPlains(max_id, clauses, weight);
     case ONE_BY_ONE:
       return new CheckCandidatesOneByOne(max_id, clauses, weight);
+    case CHUNKS:
+      return new CheckCandidatesInChunks(max_id, clauses, weight);
     default:
       return new RushAndPray(max_id, clauses, weight);
   }
@@ -118,6 +122,7 @@ int run_detector(ostream& output) {
   pdetector = create_detector(detector_type, reader.get_max_id(),
                               reader.get_clause_vector(), attention_weight);
   BackBone& detector = *pdetector;
+  detector.set_model_rotation(model_rotation);
 
   // Initialize detector
   auto start_init = high_resolution_clock::now();
@@ -197,7 +202,7 @@ void print_backbone(const BackBone& worker, const Range& range,
 bool parse_options(int argc, char** argv) {
   opterr = 0;
   int c;
-  while ((c = getopt(argc, argv, "hfora:")) != -1) {
+  while ((c = getopt(argc, argv, "hforcma:")) != -1) {
     switch (c) {
       case 'h':
         print_help = true;
@@ -211,6 +216,12 @@ bool parse_options(int argc, char** argv) {
       case 'r':
         detector_type = RUSH;
         break;
+      case 'c':
+        detector_type = CHUNKS;
+        break;
+      case 'm':
+        model_rotation = true;
+        break;
       case 'a':
         attention_weight = atof(optarg);
         if (attention_weight < 0) {
@@ -332,8 +343,11 @@ void print_usage() {
   cout << "    -f          ... use << fast on cliffs and slow on Flatlands >>" << endl;
   cout << "    -o          ... use << check candidates One by one >>" << endl;
   cout << "    -r          ... use << Rush and pray >> (default behaviour)" << endl;
+  cout << "    -c          ... use << check candidates in Chunks >>" << endl;
   cout << "    -a <weight> ... set << Attention Weight >> (default: 1.0)"
        << endl;
+  cout << "    -m          ... refute candidates by flipping them in each model"
+       << endl;
   cout << "    -h ... show this help message" << endl;
   cout << "NOTES:" << endl;
   cout << "   if filename is '-', instance is read from the standard input "
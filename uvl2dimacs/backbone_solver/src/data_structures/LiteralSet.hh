@@ -9,6 +9,7 @@
 #ifndef LITERALSET_HH
 #define LITERALSET_HH
 
+#include <cstdint>
 #include <vector>
 
 #include "minisat_interface/minisat_aux.hh"
@@ -22,13 +23,15 @@ class LiteralSet;
  *
  * This iterator wraps around when it reaches the end of the set,
  * making it useful for round-robin processing of backbone candidates.
+ * Removing the current literal moves the last one into its position, so the
+ * moved literal is visited in the next round.
  */
 class const_infinite_LiteralSetIterator {
  public:
   /**
    * @brief Construct an infinite iterator
    * @param ls The LiteralSet to iterate over
-   * @param x Starting position (index in internal storage)
+   * @param x Starting position (index in the dense storage)
    */
   const_infinite_LiteralSetIterator(const LiteralSet& ls, size_t x);
 
@@ -52,6 +55,15 @@ class const_infinite_LiteralSetIterator {
    */
   inline const Lit operator*() const;
 
+  /**
+   * @brief Move back to the start of the internal storage
+   *
+   * Must be called after the underlying set has been cleared and refilled,
+   * so that the next increment lands on the first literal again (the
+   * increment wraps the position around to 0).
+   */
+  void rewind() { i = static_cast<size_t>(-1); }
+
   /**
    * @brief Equality comparison
    * @param rhs Iterator to compare with
@@ -74,7 +86,7 @@ class const_infinite_LiteralSetIterator {
 
  private:
   const LiteralSet& ls;  ///< Reference to the LiteralSet being iterated
-  size_t i;              ///< Current position in internal storage
+  size_t i;              ///< Current position in the dense storage
 };
 
 /**
@@ -94,7 +106,7 @@ class const_LiteralSetIterator {
   /**
    * @brief Construct an iterator
    * @param ls The LiteralSet to iterate over
-   * @param x Starting position (index in internal storage)
+   * @param x Starting position (index in the dense storage)
    */
   const_LiteralSetIterator(const LiteralSet& ls, size_t x);
 
@@ -139,7 +151,7 @@ class const_LiteralSetIterator {
 
  private:
   const LiteralSet& ls;  ///< Reference to the LiteralSet being iterated
-  size_t i;              ///< Current position in internal storage
+  size_t i;              ///< Current position in the dense storage
 };
 
 /**
@@ -147,11 +159,16 @@ class const_LiteralSetIterator {
  * @brief Efficient bit-set for storing MiniSat literals
  *
  * A high-performance data structure for storing sets of literals.
- * Uses vector<uint8_t> instead of vector<bool> for much better performance.
  * Provides O(1) add, remove, and membership testing operations.
  *
- * The internal representation uses one byte per possible literal index,
- * where each byte is either 0 (not present) or 1 (present).
+ * The literals are kept twice:
+ * - a bitset with one bit per possible literal index (64 per word) answers
+ *   membership tests;
+ * - a dense array holds the literals in the set. Removal moves the last
+ *   literal into the freed slot, so iteration and discard_from_model() cost
+ *   O(size()) however sparse the set has become.
+ *
+ * Iteration order is the order of the dense array, not the literal order.
  *
  * Example usage:
  * @code
@@ -172,7 +189,7 @@ class LiteralSet {
   /**
    * @brief Construct an empty LiteralSet
    */
-  LiteralSet() : _size(0) {}
+  LiteralSet() {}
 
   /**
    * @brief Add a literal to the set
@@ -207,8 +224,7 @@ class LiteralSet {
    * @brief Ultra-fast bulk removal based on solver model
    *
    * Removes all candidate literals that are contradicted by the given
-   * satisfying assignment. Uses manual loop unrolling and branch hints
-   * for maximum performance.
+   * satisfying assignment. Only the literals in the set are visited.
    *
    * @tparam ModelVec Type of model vector (must support operator[] and size())
    * @param model Satisfying assignment from solver
@@ -223,7 +239,7 @@ class LiteralSet {
    * @brief Get the number of literals in the set
    * @return Number of literals currently stored
    */
-  size_t size() const { return _size; }
+  size_t size() const { return lits.size(); }
 
   /**
    * @brief Create an infinite iterator that cycles through the set
@@ -234,10 +250,11 @@ class LiteralSet {
   }
 
   /**
-   * @brief Get the physical size of internal storage
-   * @return Size of internal vector (>= logical size)
+   * @brief Get the literal at a position of the dense storage
+   * @param i Position, 0 <= i < size()
+   * @return The literal stored at that position
    */
-  size_t physical_size() const { return set.size(); }
+  Lit at(size_t i) const { return lits[i]; }
 
   /**
    * @brief Get iterator to first literal
@@ -252,92 +269,104 @@ class LiteralSet {
   inline const_iterator end() const;
 
  private:
-  size_t _size;          ///< Number of literals in the set
-  vector<uint8_t> set;   ///< Bit-set storage (uint8_t is much faster than vector<bool>)
+  /// Remove the literal at a position of the dense storage
+  inline void remove_at(size_t i);
+
+  vector<Lit> lits;          ///< Literals in the set (dense, unordered)
+  vector<uint32_t> where;    ///< Position in lits of each literal index in the set
+  vector<uint64_t> bits;     ///< Membership bitset, one bit per literal index
 };
 
 // Inline implementations
 
 inline bool LiteralSet::add(Lit l) {
   const size_t li = literal_index(l);
-  if (li >= set.size()) set.resize(li + 1, 0);
-  if (set[li]) return false;
-  set[li] = 1;
-  ++_size;
+  const size_t word = li >> 6;
+  const uint64_t mask = uint64_t(1) << (li & 63);
+  if (word >= bits.size()) bits.resize(word + 1, 0);
+  if (bits[word] & mask) return false;
+  bits[word] |= mask;
+  if (li >= where.size()) where.resize(li + 1);
+  where[li] = (uint32_t)lits.size();
+  lits.push_back(l);
   return true;
 }
 
+inline void LiteralSet::remove_at(size_t i) {
+  const size_t li = literal_index(lits[i]);
+  bits[li >> 6] &= ~(uint64_t(1) << (li & 63));
+  const Lit last = lits.back();
+  lits[i] = last;
+  where[literal_index(last)] = (uint32_t)i;
+  lits.pop_back();
+}
+
 inline bool LiteralSet::remove(Lit l) {
-  const size_t li = literal_index(l);
-  if (li >= set.size()) return false;
-  if (!set[li]) return false;
-  set[li] = 0;
-  --_size;
+  if (!get(l)) return false;
+  remove_at(where[literal_index(l)]);
   return true;
 }
 
 inline bool LiteralSet::get(Lit l) const {
   const size_t li = literal_index(l);
-  if (li >= set.size()) return false;
-  return set[li];
+  const size_t word = li >> 6;
+  if (word >= bits.size()) return false;
+  return (bits[word] >> (li & 63)) & 1;
 }
 
 inline void LiteralSet::clear() {
-  set.clear();
-  _size = 0;
+  // Clear only the words in use instead of reallocating the bitset
+  for (const Lit l : lits) {
+    const size_t li = literal_index(l);
+    bits[li >> 6] = 0;
+  }
+  lits.clear();
 }
 
 inline const_infinite_LiteralSetIterator&
 const_infinite_LiteralSetIterator::operator++() {
   if (!ls.size()) return *this;
-  assert(i < ls.physical_size());
-  assert(0 <= i);
-  do {
-    i = (i + 1) % ls.physical_size();
-  } while (i < 2 || !ls.get(index2literal(i)));
-  assert(ls.get(index2literal(i)));
+  ++i;
+  if (i >= ls.size()) i = 0;
   return *this;
 }
 
 inline const Lit const_infinite_LiteralSetIterator::operator*() const {
-  const Lit return_value = index2literal(i);
+  assert(i < ls.size());
+  const Lit return_value = ls.at(i);
   assert(ls.get(return_value));
   return return_value;
 }
 
 inline const_LiteralSetIterator& const_LiteralSetIterator::operator++() {
-  assert(i < ls.physical_size());
+  assert(i < ls.size());
   ++i;
-  while ((i < ls.physical_size()) && !ls.get(index2literal(i))) ++i;
   return *this;
 }
 
 inline const Lit const_LiteralSetIterator::operator*() const {
-  const Lit r = index2literal(i);
-  assert(ls.get(r));
-  return r;
+  assert(i < ls.size());
+  return ls.at(i);
 }
 
 inline LiteralSet::const_iterator LiteralSet::end() const {
-  return const_LiteralSetIterator(*this, physical_size());
+  return const_LiteralSetIterator(*this, size());
 }
 inline LiteralSet::const_iterator LiteralSet::begin() const {
-  return const_LiteralSetIterator(*this, 2);
+  return const_LiteralSetIterator(*this, 0);
 }
 
 /**
- * @brief Specialized ultra-fast bulk discard based on solver model
+ * @brief Bulk discard based on solver model
  *
  * This template function removes all candidate literals that are
  * contradicted by a satisfying assignment. For example, if variable x
  * is true in the model, then the literal -x is not in the backbone
  * and can be discarded.
  *
- * Performance optimizations:
- * - Manual loop unrolling (4 variables at a time)
- * - Branch prediction hints with __builtin_expect
- * - Early exit when all literals removed
- * - Cache-friendly chunked processing
+ * The scan walks the dense array, so its cost is proportional to the
+ * number of candidates left rather than to the number of variables.
+ * A removed literal is replaced by the last one, which is examined next.
  *
  * @tparam ModelVec Type of model vector (vec<lbool> or similar)
  * @param model Satisfying assignment from the solver
@@ -348,47 +377,21 @@ template <typename ModelVec>
 inline void LiteralSet::discard_from_model(const ModelVec& model, int max_var,
                                            vec<Lit>& discarded) {
   discarded.clear();
-  if (_size == 0) return;
-
   const int model_size = model.size();
   const int limit = (max_var < model_size - 1) ? max_var : model_size - 1;
 
-  size_t removed = 0;
-
-  // Process in chunks for better cache utilization
-  for (int var = 1; var <= limit; var += 4) {
-    // Unroll loop manually for better performance
-    const int end = (var + 3 <= limit) ? var + 3 : limit;
-
-    for (int v = var; v <= end; ++v) {
-      const auto value = model[v];
-
-      // Branchless selection: compute both, use based on value
-      const size_t li_pos = literal_index(mkLit(v, false));
-      const size_t li_neg = literal_index(mkLit(v, true));
-
-      if (__builtin_expect(value == l_True, 1)) {
-        // Remove negative literal
-        if (__builtin_expect(li_neg < set.size() && set[li_neg], 1)) {
-          set[li_neg] = 0;
-          discarded.push(mkLit(v, true));
-          ++removed;
-        }
-      } else if (__builtin_expect(value == l_False, 1)) {
-        // Remove positive literal
-        if (__builtin_expect(li_pos < set.size() && set[li_pos], 1)) {
-          set[li_pos] = 0;
-          discarded.push(mkLit(v, false));
-          ++removed;
-        }
-      }
+  size_t i = 0;
+  while (i < lits.size()) {
+    const Lit l = lits[i];
+    const int v = var(l);
+    // l is contradicted if the model gives its variable the opposite value
+    if (v <= limit && model[v] == (sign(l) ? l_True : l_False)) {
+      discarded.push(l);
+      remove_at(i);
+    } else {
+      ++i;
     }
-
-    // Early exit if we've removed everything
-    if (__builtin_expect(removed >= _size, 0)) break;
   }
-
-  _size -= removed;
 }
 
 #endif  // LITERALSET_HH
@@ -0,0 +1,166 @@
+/**
+ * @file OccurrenceLists.hh
+ * @brief Clauses indexed by literal, for model rotation
+ *
+ * Provides the occurrence lists of a CNF formula and the flip test used by
+ * the detectors to refute candidates without calling the SAT solver.
+ */
+
+#ifndef OCCURRENCELISTS_HH
+#define OCCURRENCELISTS_HH
+
+#include <vector>
+
+#include "DIMACSReader.hh"
+#include "LiteralSet.hh"
+#include "minisat_interface/minisat_aux.hh"
+using std::vector;
+
+/**
+ * @class OccurrenceLists
+ * @brief Read-only copy of a CNF formula indexed by literal
+ *
+ * For every literal, lists the clauses that contain it. Both the clauses
+ * and the lists are stored in flat arrays (offsets plus contents), so a
+ * flip test walks contiguous memory.
+ *
+ * Model rotation: if every clause containing a literal l that is true in a
+ * model has another true literal, the model with the variable of l flipped
+ * still satisfies the formula. l is then false in some model, so it is not
+ * in the backbone and no SAT call is needed to refute it.
+ *
+ * Example usage:
+ * @code
+ * OccurrenceLists occurrences;
+ * occurrences.build(max_id, clauses);
+ * solver.model.copyTo(rotated);
+ * occurrences.rotate(candidates, rotated, refuted);
+ * @endcode
+ */
+class OccurrenceLists {
+ public:
+  /**
+   * @brief Construct empty occurrence lists
+   */
+  OccurrenceLists() : built(false) {}
+
+  /**
+   * @brief Index a formula
+   *
+   * Replaces the lists of a previously indexed formula.
+   *
+   * @param max_var Maximum variable ID of the formula
+   * @param clauses The formula
+   */
+  inline void build(Var max_var, const CNF& clauses);
+
+  /**
+   * @brief Check whether build() has been called
+   * @return true once a formula is indexed
+   */
+  bool is_built() const { return built; }
+
+  /**
+   * @brief Check whether a literal can be flipped in a model
+   *
+   * @tparam ModelVec Type of model vector (vec<lbool> or similar)
+   * @param l Literal true in the model, of a variable of the formula
+   * @param model Satisfying assignment of the indexed formula
+   * @return true if every clause containing l has another literal true in
+   *         the model, so the model with l flipped satisfies the formula
+   */
+  template <typename ModelVec>
+  inline bool can_flip(Lit l, const ModelVec& model) const;
+
+  /**
+   * @brief Flip, one after the other, the literals of a set that can be flipped
+   *
+   * Each literal is tested against the model left by the previous flips, so
+   * the result is still a model of the formula, in which every flipped
+   * literal is false.
+   *
+   * @tparam ModelVec Type of model vector (vec<lbool> or similar)
+   * @param literals Literals true in the model (typically the candidates
+   *                 left after LiteralSet::discard_from_model())
+   * @param model Input: satisfying assignment of the indexed formula.
+   *              Output: the rotated assignment
+   * @param flipped Output: the flipped literals
+   */
+  template <typename ModelVec>
+  inline void rotate(const LiteralSet& literals, ModelVec& model,
+                     vec<Lit>& flipped) const;
+
+ private:
+  bool built;                       ///< Whether a formula is indexed
+  vector<int> clause_start;         ///< Offset in clause_lits of each clause
+  vector<Lit> clause_lits;          ///< Literals of all clauses, back to back
+  vector<int> occurrence_start;     ///< Offset in occurrences of each literal index
+  vector<int> occurrences;          ///< Clauses of each literal, back to back
+};
+
+// Inline implementations
+
+inline void OccurrenceLists::build(Var max_var, const CNF& clauses) {
+  const size_t indices = 2 * (size_t)max_var + 2;
+  clause_start.clear();
+  clause_lits.clear();
+  occurrence_start.assign(indices + 1, 0);
+
+  // Copy the clauses and count the occurrences of each literal
+  for (const LitSet& clause : clauses) {
+    clause_start.push_back((int)clause_lits.size());
+    for (auto li = clause.begin(); li != clause.end(); ++li) {
+      clause_lits.push_back(*li);
+      ++occurrence_start[literal_index(*li) + 1];
+    }
+  }
+  clause_start.push_back((int)clause_lits.size());
+
+  // Turn the counts into offsets and fill the lists
+  for (size_t i = 1; i <= indices; ++i) {
+    occurrence_start[i] += occurrence_start[i - 1];
+  }
+  occurrences.resize(clause_lits.size());
+  vector<int> next(occurrence_start.begin(), occurrence_start.end() - 1);
+  for (int c = 0; c + 1 < (int)clause_start.size(); ++c) {
+    for (int i = clause_start[c]; i < clause_start[c + 1]; ++i) {
+      occurrences[next[literal_index(clause_lits[i])]++] = c;
+    }
+  }
+  built = true;
+}
+
+template <typename ModelVec>
+inline bool OccurrenceLists::can_flip(Lit l, const ModelVec& model) const {
+  const size_t li = literal_index(l);
+  if (li + 1 >= occurrence_start.size()) return true;
+  for (int o = occurrence_start[li]; o < occurrence_start[li + 1]; ++o) {
+    const int c = occurrences[o];
+    bool supported = false;
+    for (int i = clause_start[c]; i < clause_start[c + 1]; ++i) {
+      const Lit m = clause_lits[i];
+      if (m != l && model[var(m)] == (sign(m) ? l_False : l_True)) {
+        supported = true;
+        break;
+      }
+    }
+    // l is the only true literal of the clause: flipping it falsifies it
+    if (!supported) return false;
+  }
+  return true;
+}
+
+template <typename ModelVec>
+inline void OccurrenceLists::rotate(const LiteralSet& literals, ModelVec& model,
+                                    vec<Lit>& flipped) const {
+  flipped.clear();
+  for (auto li = literals.begin(); li != literals.end(); ++li) {
+    const Lit l = *li;
+    if (can_flip(l, model)) {
+      model[var(l)] = sign(l) ? l_True : l_False;
+      flipped.push(l);
+    }
+  }
+}
+
+#endif  // OCCURRENCELISTS_HH
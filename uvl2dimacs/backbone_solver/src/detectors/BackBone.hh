@@ -8,6 +8,11 @@
 #ifndef BACKBONE_HH
 #define BACKBONE_HH
 
+#include <cstdint>
+#include <functional>
+
+#include "LiteralSet.hh"
+#include "OccurrenceLists.hh"
 #include "minisat_interface/MiniSatExt.hh"
 
 /**
@@ -45,6 +50,13 @@
  * - **Description:** Automatically switches between rapid elimination (cliffs) and
  *   careful verification (plains) based on convergence rate
  *
+ * ### 4. CheckCandidatesInChunks
+ * - **Class:** bonedigger::CheckCandidatesInChunks
+ * - **Strategy:** Groups of candidates assumed false together, narrowed by the unsat core
+ * - **Best for:** Formulas with large backbones, where one UNSAT call per literal dominates
+ * - **Description:** A model refutes several candidates of the group at once; an UNSAT
+ *   answer is reduced to the candidates in the final conflict, which are proven together
+ *
  * ## Implementing a New Detector
  *
  * To add a new backbone detection algorithm, create a class that inherits from
@@ -57,12 +69,15 @@
  *
  * class MyDetector : public BackBone {
  * public:
- *     MyDetector(Var max_id, const CNF& clauses);
+ *     MyDetector(Var max_id, const CNF& clauses) : BackBone(max_id, clauses) {}
  *     ~MyDetector();
  *
  *     // Required: Check satisfiability and initialize data structures
  *     bool initialize() override;
  *
+ *     // Required: Same as initialize(), under a set of solver assumptions
+ *     bool initialize(const vec<Lit>& assumptions) override;
+ *
  *     // Required: Execute the backbone detection algorithm
  *     void run() override;
  *
@@ -76,9 +91,8 @@
  *     bool backbone_sign(Var var) const override;
  *
  * private:
- *     MiniSatExt solver;
- *     LiteralSet backbone;
- *     // ... other data structures
+ *     // ... data structures of the algorithm; the solver, the candidates
+ *     // and the backbone are protected members of BackBone
  * };
  *
  * } // namespace bonedigger
@@ -89,24 +103,46 @@
  * 1. **initialize()**: Must check satisfiability using a SAT solver and return the result.
  *    If satisfiable, set up initial data structures for backbone detection.
  *
- * 2. **run()**: Should only be called after initialize() returns true. This method
+ * 2. **initialize(assumptions)**: Same contract as initialize(), but the backbone
+ *    is computed for the formula restricted by the assumptions. The assumptions are
+ *    passed to the solver rather than added as clauses, so the detector may be
+ *    initialized again with different assumptions. The formula is loaded into the
+ *    solver only once and learnt clauses are kept between calls.
+ *
+ * 3. **run()**: Should only be called after initialize() returns true. This method
  *    performs the actual backbone computation. After completion, is_backbone() queries
  *    must return correct results.
  *
- * 3. **is_backbone() methods**: Should return true only for literals/variables that
+ * 4. **is_backbone() methods**: Should return true only for literals/variables that
  *    are proven to be in the backbone (must have the same value in ALL satisfying
  *    assignments).
  *
- * 4. **backbone_sign()**: Should only be called for variables known to be in the
+ * 5. **backbone_sign()**: Should only be called for variables known to be in the
  *    backbone. Returns true if the variable must be positive, false if negative.
  *
+ * 6. **refute()** / **confirm()**: Remove the given literals from the candidates,
+ *    respectively dropping them or moving them into the backbone. BackBone
+ *    implements both on its candidates. Every model found should be passed
+ *    to notify_model() so that callers can reuse it.
+ *
+ * 7. **Conflict budget**: run() starts the budget set with set_conflict_budget()
+ *    (solver.setConfBudget()) and calls solver.solveLimited(). When a call
+ *    returns l_Undef, run() stops, sets budget_exhausted, and get_unknown()
+ *    returns the remaining candidates. The backbone found so far stays exact.
+ *    interrupt() ends a run() the same way, from any thread.
+ *
  * ### Common Patterns
  *
  * Most detectors follow this pattern:
- * - Use a MiniSatExt solver for SAT queries
- * - Store backbone literals in a LiteralSet for efficient membership testing
+ * - Load the formula into the MiniSatExt solver on the first initialize(), and
+ *   call reset_state() at the start of every initialize()
+ * - Keep candidate and backbone literals in the LiteralSets candidates and backbone
  * - Use activity bumping (solver.bump()) to guide solver toward relevant solutions
  * - Maintain a set of candidate literals and iteratively eliminate non-backbone candidates
+ * - Move candidates implied by unit propagation of the assumptions (Solver::implies)
+ *   straight into the backbone before the first UNSAT proof
+ * - With set_model_rotation(), also drop the candidates that can be flipped in
+ *   each model with rotate_model()
  *
  * ### Integration
  *
@@ -120,6 +156,30 @@
 namespace bonedigger {
 using Minisat::Lit;
 using Minisat::Var;
+using Minisat::vec;
+
+/**
+ * @brief Callback receiving every satisfying assignment found by a detector
+ *
+ * The model is indexed by variable and may be longer than the formula
+ * (auxiliary solver variables). It is only valid during the call.
+ */
+typedef std::function<void(const vec<Minisat::lbool>& model)> ModelObserver;
+
+/**
+ * @brief Work counters of a detector, accumulated over all its queries
+ *
+ * Callers interested in a single query take the difference of two snapshots.
+ */
+struct DetectorStats {
+  uint64_t solves = 0;                ///< SAT calls
+  uint64_t models = 0;                ///< SAT calls that found a model
+  uint64_t conflicts = 0;             ///< Solver conflicts
+  uint64_t eliminated_by_models = 0;  ///< Candidates discarded by the detector's models (rotated ones included)
+  uint64_t refuted = 0;               ///< Candidates dropped by refute()
+  uint64_t confirmed = 0;             ///< Candidates accepted without an UNSAT proof (confirm(), level-0 units)
+  uint64_t interrupted = 0;           ///< Runs stopped by the conflict budget or interrupt(), each on an unanswered SAT call
+};
 
 /**
  * @class BackBone
@@ -132,6 +192,7 @@ using Minisat::Var;
  *
  * All derived classes must implement:
  * - initialize(): Check satisfiability and set up data structures
+ * - initialize(assumptions): Same, for the formula under solver assumptions
  * - run(): Execute the backbone detection algorithm
  * - is_backbone(): Query whether a literal/variable is in the backbone
  * - backbone_sign(): Get the sign of a backbone variable
@@ -144,6 +205,10 @@ using Minisat::Var;
  *     // Query results with is_backbone() and backbone_sign()
  * }
  * @endcode
+ *
+ * A detector can be reused for several queries over the same formula by
+ * calling initialize(assumptions) before each run(). Every call discards the
+ * result of the previous query.
  */
 class BackBone {
  public:
@@ -167,6 +232,23 @@ class BackBone {
    */
   virtual bool initialize() = 0;
 
+  /**
+   * @brief Initialize the detector under a set of assumptions
+   *
+   * Like initialize(), but the backbone is computed for the formula
+   * restricted by the given assumptions. The assumptions are passed to the
+   * SAT solver on every call instead of being added as unit clauses, so the
+   * same detector (and its learnt clauses) can be reused for many queries.
+   * Any result from a previous query is discarded.
+   *
+   * Must be called before run().
+   *
+   * @param assumptions Literals assumed to be true for this query
+   * @return true if the formula is satisfiable under the assumptions
+   * @return false otherwise
+   */
+  virtual bool initialize(const vec<Lit>& assumptions) = 0;
+
   /**
    * @brief Run the backbone detection algorithm
    *
@@ -208,6 +290,281 @@ class BackBone {
    * @return false if the variable must be negative/false in all satisfying assignments
    */
   virtual bool backbone_sign(Var var) const = 0;
+
+  /**
+   * @brief Discard candidates already known not to be in the backbone
+   *
+   * Typically the literals are refuted by models found in earlier queries.
+   * Must be called after initialize() and before run(); it saves the SAT
+   * calls that would otherwise be spent on these candidates.
+   *
+   * @param literals Literals that are false in some model of the current query
+   */
+  void refute(const vec<Lit>& literals) {
+    for (int i = 0; i < literals.size(); ++i) {
+      if (candidates.remove(literals[i])) {
+        solver.reset_activity_for_var(var(literals[i]));
+        solver.reset_detector_polarity(var(literals[i]));
+        ++stats.refuted;
+      }
+    }
+  }
+
+  /**
+   * @brief Move candidates already known to be in the backbone into it
+   *
+   * Typically the literals follow from earlier queries (e.g. the backbone of
+   * a literal implied by the current assumptions). Must be called after
+   * initialize() and before run(); the UNSAT proofs for these candidates
+   * are skipped. Literals that are not candidates are ignored.
+   *
+   * @param literals Literals that hold in every model of the current query
+   */
+  void confirm(const vec<Lit>& literals) {
+    for (int i = 0; i < literals.size(); ++i) {
+      if (candidates.remove(literals[i])) {
+        backbone.add(literals[i]);
+        solver.reset_activity_for_var(var(literals[i]));
+        solver.reset_detector_polarity(var(literals[i]));
+        ++stats.confirmed;
+      }
+    }
+  }
+
+  /**
+   * @brief Limit the conflicts spent by each run()
+   *
+   * The budget covers all the SAT calls of one run(); the satisfiability
+   * check of initialize() is not limited. When it is exhausted, run() returns
+   * early: every literal reported by is_backbone() is still proven, and the
+   * candidates left undecided are reported by get_unknown().
+   *
+   * @param conflicts Conflicts per run, or a negative value for no limit (default)
+   */
+  void set_conflict_budget(int64_t conflicts) { conflict_budget = conflicts; }
+
+  /**
+   * @brief Enable model rotation
+   *
+   * After every model, the remaining candidates are flipped one after the
+   * other as long as all the clauses of the formula stay satisfied (see
+   * OccurrenceLists). The flipped candidates are discarded without a SAT
+   * call, and the rotated model goes to the model observer. The occurrence
+   * lists are built on first use.
+   *
+   * @param enabled true to rotate models (default: false)
+   */
+  void set_model_rotation(bool enabled) { model_rotation = enabled; }
+
+  /**
+   * @brief Check whether the last run() decided every candidate
+   *
+   * @return false if the conflict budget stopped it early
+   */
+  bool is_complete() const { return !budget_exhausted; }
+
+  /**
+   * @brief Get the candidates left undecided by the last run()
+   *
+   * Each of them may or may not be in the backbone. Empty when is_complete().
+   *
+   * @param literals Output: the undecided candidates
+   */
+  void get_unknown(vec<Lit>& literals) const {
+    literals.clear();
+    if (!budget_exhausted) return;
+    for (auto li = candidates.begin(); li != candidates.end(); ++li) {
+      literals.push(*li);
+    }
+  }
+
+  /**
+   * @brief Stop the query in progress as soon as possible
+   *
+   * May be called from another thread. The SAT call in progress returns
+   * without an answer and run() ends as if its budget were exhausted, so
+   * is_complete() is false. The interrupt stays set until clear_interrupt();
+   * an interrupted initialize() returns false.
+   */
+  void interrupt() { solver.interrupt(); }
+
+  /**
+   * @brief Clear an interrupt, so that the next query runs normally
+   *
+   * Must not be called while a query is in progress.
+   */
+  void clear_interrupt() { solver.clearInterrupt(); }
+
+  /**
+   * @brief Register a callback for every model found by the detector
+   *
+   * @param observer Callback, or an empty function to disable it
+   */
+  void set_model_observer(ModelObserver observer) { model_observer = observer; }
+
+  /**
+   * @brief Get the work counters accumulated since construction
+   *
+   * Detectors add the counters of their SAT solver to the ones kept here.
+   */
+  virtual DetectorStats get_stats() const { return stats; }
+
+ protected:
+  /**
+   * @brief Set up the state shared by the detectors
+   *
+   * @param max_id Maximum variable ID of the formula
+   * @param clauses The formula; it must outlive the detector
+   */
+  BackBone(Var _max_id, const CNF& _clauses)
+      : max_id(_max_id), clauses(_clauses), candidates_iterator(candidates.infinite_iterator()) {}
+
+  /**
+   * @brief Forward a satisfying assignment to the registered observer
+   *
+   * Also counts the model in the detector statistics.
+   *
+   * @param model The solver model
+   */
+  void notify_model(const vec<Minisat::lbool>& model) {
+    ++stats.models;
+    if (model_observer) model_observer(model);
+  }
+
+  /**
+   * @brief Forward a model obtained by rotation to the registered observer
+   *
+   * Unlike notify_model(), the model is not counted: no SAT call found it.
+   *
+   * @param model The rotated model
+   */
+  void notify_rotated_model(const vec<Minisat::lbool>& model) {
+    if (model_observer) model_observer(model);
+  }
+
+  /**
+   * @brief Discard the candidates that can be flipped in the solver model
+   *
+   * Called after every model when model rotation is enabled. Flips the
+   * candidates one after the other (OccurrenceLists::rotate()), removes the
+   * flipped ones and clears their detector activity and polarity, and passes
+   * the rotated model to the observer. The occurrence lists are built on
+   * first use. No candidate may be an assumption of the query (initialize()
+   * confirms them), so the rotated model is a model of the query.
+   *
+   * @param discarded Output: the discarded candidates
+   */
+  void rotate_model(vec<Lit>& discarded) {
+    if (!occurrences.is_built()) occurrences.build(max_id, clauses);
+    solver.model.copyTo(rotated);
+    occurrences.rotate(candidates, rotated, discarded);
+    if (discarded.size()) notify_rotated_model(rotated);
+    stats.eliminated_by_models += discarded.size();
+    for (int i = 0; i < discarded.size(); ++i) {
+      const Var v = var(discarded[i]);
+      candidates.remove(discarded[i]);
+      solver.reset_activity_for_var(v);
+      solver.reset_detector_polarity(v);
+    }
+  }
+
+  /**
+   * @brief Forget the candidates and backbone of the previous query
+   *
+   * Also clears the detector activity and polarity left on their variables.
+   * Called by initialize() before its first SAT call.
+   */
+  void reset_state() {
+    for (auto li = candidates.begin(); li != candidates.end(); ++li) {
+      const Var v = var(*li);
+      solver.reset_activity_for_var(v);
+      solver.reset_detector_polarity(v);
+    }
+    for (auto li = backbone.begin(); li != backbone.end(); ++li) {
+      const Var v = var(*li);
+      solver.reset_activity_for_var(v);
+      solver.reset_detector_polarity(v);
+    }
+    candidates.clear();
+    backbone.clear();
+    candidates_iterator.rewind();
+    budget_exhausted = false;
+  }
+
+  /**
+   * @brief Confirm the candidates that follow by unit propagation
+   *
+   * Probes the fixed assumptions with BCP only: the propagated literals, the
+   * assumptions themselves and the literals fixed at decision level 0 hold in
+   * every model, so they move straight into the backbone. Propagation takes
+   * microseconds where an UNSAT proof takes a full SAT call.
+   */
+  void confirm_propagated() {
+    // Literals propagated from the assumptions hold in every model
+    if (!solver.implies(fixed_assumptions, propagated)) {
+      return;
+    }
+    // So do the assumptions themselves and the literals fixed at level 0
+    for (int i = 0; i < fixed_assumptions.size(); ++i) {
+      propagated.push(fixed_assumptions[i]);
+    }
+    for (auto li = solver.trailBegin(); li != solver.trailEnd(); ++li) {
+      propagated.push(*li);
+    }
+    confirm(propagated);
+  }
+
+  /**
+   * @brief Confirm the candidates fixed at decision level 0 since the last check
+   *
+   * The units the solver learns during search hold in every model, so they
+   * skip their own UNSAT proofs. Detectors call this after the SAT calls of
+   * run() that may have learnt some.
+   */
+  void confirm_fixed() {
+    solver.new_level0_literals(max_id, propagated);
+    confirm(propagated);
+  }
+
+  /**
+   * @brief Start the conflict budget of a run() on the detector's solver
+   *
+   * @param solver The solver used by run()
+   */
+  void start_budget(Minisat::MiniSatExt& solver) {
+    if (conflict_budget >= 0) {
+      solver.setConfBudget(conflict_budget);
+    } else {
+      solver.budgetOff();
+    }
+  }
+
+  /**
+   * @brief Record that run() stopped because the budget was exhausted
+   */
+  void stop_on_budget() {
+    budget_exhausted = true;
+    ++stats.interrupted;
+  }
+
+  const Var max_id;              ///< Maximum variable ID
+  const CNF& clauses;            ///< CNF formula to analyze
+  Minisat::MiniSatExt solver;    ///< SAT solver, loaded with the formula on first use
+  LiteralSet candidates;         ///< Literals that might be backbones
+  LiteralSet backbone;           ///< Confirmed backbone literals
+  vec<Lit> fixed_assumptions;    ///< Assumptions of the current query
+  vec<Lit> propagated;           ///< Literals implied by propagation
+  const_infinite_LiteralSetIterator candidates_iterator;  ///< Cycles through candidates
+
+  DetectorStats stats;          ///< Counters maintained by the detector
+  int64_t conflict_budget = -1;  ///< Conflicts per run(), negative for no limit
+  bool budget_exhausted = false; ///< Whether the last run() ran out of budget
+  bool model_rotation = false;   ///< Whether models are rotated (set_model_rotation())
+
+ private:
+  ModelObserver model_observer;  ///< Receives every model found
+  OccurrenceLists occurrences;   ///< Clauses by literal, for model rotation
+  vec<Minisat::lbool> rotated;   ///< Model being rotated
 };
 
 }  // end of namespace bonedigger
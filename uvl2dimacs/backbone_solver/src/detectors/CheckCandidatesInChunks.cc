@@ -0,0 +1,141 @@
+/**
+ * @file CheckCandidatesInChunks.cc
+ * @brief Implementation file for CheckCandidatesInChunks
+ */
+
+#include <algorithm>
+#include <iostream>
+
+#include "CheckCandidatesInChunks.hh"
+using namespace bonedigger;
+using Minisat::lit_Undef;
+
+// Initialization
+CheckCandidatesInChunks::CheckCandidatesInChunks(Var _max_id,
+                                                 const CNF& _clauses,
+                                                 double _attention_weight)
+    : CheckCandidatesOneByOne(_max_id, _clauses, _attention_weight),
+      chunk_size(INITIAL_CHUNK_SIZE) {}
+
+CheckCandidatesInChunks::~CheckCandidatesInChunks() {}
+
+// Run of the worker
+void CheckCandidatesInChunks::run() {
+  start_budget(solver);
+  while (candidates.size()) {
+    // The next chunk_size candidates in round-robin order
+    next_chunk();
+
+    // Try to falsify the whole chunk in a single model
+    negated.clear();
+    for (int i = 0; i < chunk.size(); ++i) {
+      negated.push(~chunk[i]);
+    }
+    const lbool result = bump_and_solve(negated);
+    if (result == l_Undef) {
+      // Out of budget: the remaining candidates stay unknown
+      stop_on_budget();
+      break;
+    }
+    if (result == l_True) {
+      // Every literal of the chunk is refuted: try larger chunks
+      discard_candidates();
+      chunk_size = std::max(1, std::min(2 * chunk_size, (int)candidates.size()));
+      continue;
+    }
+
+    // Some backbone literal is in the chunk: start over from single
+    // candidates. The final conflict names the chunk literals that the
+    // refutation used
+    chunk_size = 1;
+    core.clear();
+    for (int i = 0; i < chunk.size(); ++i) {
+      if (solver.conflict.has(chunk[i])) core.push(chunk[i]);
+    }
+    if (core.size() == 0) {
+      chunk.copyTo(core);
+    }
+    if (core.size() == 1) {
+      // The formula implies the only literal of the core
+      confirm_proven(core);
+    } else if (!check_core()) {
+      break;
+    }
+
+    // The clauses learnt by the refutation may let the assumptions
+    // propagate more candidates than they did in initialize()
+    if (fixed_assumptions.size() &&
+        solver.implies(fixed_assumptions, propagated)) {
+      confirm(propagated);
+    }
+    confirm_fixed();
+  }
+}
+
+void CheckCandidatesInChunks::next_chunk() {
+  chunk.clear();
+  const int size = std::min(chunk_size, (int)candidates.size());
+  // The candidates do not change while the chunk is filled, so the
+  // infinite iterator yields size different literals
+  while (chunk.size() < size) {
+    ++candidates_iterator;
+    chunk.push(*candidates_iterator);
+  }
+}
+
+bool CheckCandidatesInChunks::check_disjunction(const vec<Lit>& literals) {
+  // Clause ~lit1 or ~lit2 or ..., enabled by assuming the relaxation
+  // literal false and deleted by releasing it afterwards
+  const Lit relaxation_literal = mkLit(solver.newVar());
+  clause.clear();
+  clause.push(relaxation_literal);
+  for (int i = 0; i < literals.size(); ++i) {
+    clause.push(~literals[i]);
+  }
+  solver.addClause(clause);
+
+  vec<Lit> assumptions(1);
+  assumptions[0] = ~relaxation_literal;
+  const lbool result = bump_and_solve(assumptions);
+  solver.releaseVar(relaxation_literal);
+
+  if (result == l_Undef) {
+    // Out of budget: the remaining candidates stay unknown
+    stop_on_budget();
+    return false;
+  }
+  if (result == l_False) {
+    // No model falsifies any of them: they are all backbone
+    confirm_proven(literals);
+  } else {
+    discard_candidates();
+  }
+  return true;
+}
+
+bool CheckCandidatesInChunks::check_core() {
+  while (core.size()) {
+    if (!check_disjunction(core)) {
+      return false;
+    }
+    // Only the core as a whole is implied: a refuted literal does not make
+    // the others backbone, so the rest of the core is checked again
+    int kept = 0;
+    for (int i = 0; i < core.size(); ++i) {
+      if (candidates.get(core[i])) core[kept++] = core[i];
+    }
+    core.shrink(core.size() - kept);
+  }
+  return true;
+}
+
+void CheckCandidatesInChunks::confirm_proven(const vec<Lit>& literals) {
+  for (int i = 0; i < literals.size(); ++i) {
+    if (candidates.remove(literals[i])) {
+      backbone.add(literals[i]);
+      const Var v = var(literals[i]);
+      solver.reset_activity_for_var(v);
+      solver.reset_detector_polarity(v);
+    }
+  }
+}
@@ -0,0 +1,114 @@
+/**
+ * @file CheckCandidatesInChunks.hh
+ * @brief Core-guided backbone detection on adaptive chunks of candidates
+ *
+ * Implements a backbone detection algorithm that tests several candidates
+ * per SAT call and uses the final conflict of the solver to confirm them.
+ */
+
+#ifndef CHECKCANDIDATESINCHUNKS_HH
+#define CHECKCANDIDATESINCHUNKS_HH
+#include "CheckCandidatesOneByOne.hh"
+
+namespace bonedigger {
+
+/**
+ * @class CheckCandidatesInChunks
+ * @ingroup BackboneDetectors
+ * @brief Backbone detector testing adaptive chunks of candidates
+ *
+ * Sits between CheckCandidatesOneByOne (one candidate per SAT call) and the
+ * relaxation clause over all the candidates of RushAndPray:
+ * 1. Take the next k candidates (the chunk) and assume all of them false
+ * 2. If satisfiable, the model refutes the whole chunk and every other
+ *    candidate it falsifies; k doubles
+ * 3. If unsatisfiable, k drops back to 1 and the final conflict
+ *    (Solver::conflict) gives the chunk literals the refutation used (the
+ *    core), one of which is in the backbone:
+ *    - a single literal is implied by the formula and joins the backbone;
+ *    - for several, a relaxation clause ~l1 or ~l2 or ... over the core is
+ *      enabled for one more SAT call: unsatisfiable confirms the whole core
+ *      at once, a model refutes at least one of its literals and the check
+ *      is repeated on the rest of the core
+ *
+ * The chunk size is kept from one query to the next. Easy candidates fall
+ * by the chunk, and backbone literals are isolated by the core instead of
+ * one SAT call each.
+ *
+ * Everything but run() is inherited from CheckCandidatesOneByOne: loading
+ * the formula, the first model and the candidates, the confirmation of
+ * propagated literals, model rotation and the refutation of candidates by
+ * models.
+ */
+class CheckCandidatesInChunks : public CheckCandidatesOneByOne {
+ public:
+  /**
+   * @brief Construct detector for a CNF formula
+   *
+   * @param max_id Maximum variable ID in the formula
+   * @param clauses Vector of clauses (CNF formula)
+   * @param attention_weight Weight for detector activity in variable ordering (default 1.0)
+   */
+  CheckCandidatesInChunks(Var max_id, const CNF& clauses, double attention_weight = 1.0);
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~CheckCandidatesInChunks() override;
+
+  /**
+   * @brief Run the backbone detection algorithm
+   *
+   * Tests chunks of candidates until every candidate is refuted or
+   * confirmed. Uses activity bumping to guide the search.
+   */
+  virtual void run() override;
+
+ private:
+  /// Chunk size of the first query
+  static constexpr int INITIAL_CHUNK_SIZE = 4;
+
+  vec<Lit> chunk;                     ///< Candidates tested by the current SAT call
+  vec<Lit> negated;                   ///< Negations of the chunk, assumed together
+  vec<Lit> core;                      ///< Chunk literals in the final conflict
+  vec<Lit> clause;                    ///< Relaxation clause over the core
+  int chunk_size;                     ///< Candidates per chunk (k)
+
+  /**
+   * @brief Fill the chunk with the next chunk_size candidates
+   */
+  void next_chunk();
+
+  /**
+   * @brief Check whether some model falsifies one of the literals
+   *
+   * Adds the clause ~lit1 or ~lit2 or ... with a relaxation literal that is
+   * released after the SAT call. Confirms all the literals if there is no
+   * such model, and discards the candidates the model falsifies otherwise.
+   *
+   * @param literals Candidates to test (at least one)
+   * @return false if the conflict budget ran out
+   */
+  bool check_disjunction(const vec<Lit>& literals);
+
+  /**
+   * @brief Decide every literal of the core
+   *
+   * Repeats check_disjunction() on the core literals still in the candidates
+   * until they are all confirmed or refuted.
+   *
+   * @return false if the conflict budget ran out
+   */
+  bool check_core();
+
+  /**
+   * @brief Move candidates proven by an UNSAT call into the backbone
+   *
+   * @param literals Literals implied by the formula and the assumptions
+   */
+  void confirm_proven(const vec<Lit>& literals);
+};
+
+}  // end of namespace bonedigger
+
+#endif  // CHECKCANDIDATESINCHUNKS_HH
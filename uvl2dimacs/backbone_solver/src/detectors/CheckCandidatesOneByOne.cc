@@ -13,38 +13,37 @@ using Minisat::lit_Undef;
 CheckCandidatesOneByOne::CheckCandidatesOneByOne(Var _max_id,
                                                  const CNF& _clauses,
                                                  double _attention_weight)
-    : max_id(_max_id),
-      clauses(_clauses),
+    : BackBone(_max_id, _clauses),
       attention_weight(_attention_weight),
-      candidates_iterator(candidates.infinite_iterator()) {}
+      loaded(false) {}
 
 CheckCandidatesOneByOne::~CheckCandidatesOneByOne() {}
 
 bool CheckCandidatesOneByOne::initialize() {
-  // Initialize the solver
-  solver.set_detector_weight(attention_weight);
-  for (Var i = 0; i <= max_id; ++i) {
-    solver.newVar();
-  }
-  vec<Lit> ls;
-  for (auto ci = clauses.begin(); ci != clauses.end(); ++ci) {
-    ls.clear();
-    for (auto li = (*ci).begin(); li != (*ci).end(); ++li) {
-      const Lit l = *li;
-      assert(var(l) <= max_id);
-      ls.push(l);
-    }
-    solver.addClause(ls);
+  const vec<Lit> assumptions;
+  return initialize(assumptions);
+}
+
+bool CheckCandidatesOneByOne::initialize(const vec<Lit>& assumptions) {
+  // Load the formula the first time; later calls reuse the solver
+  if (!loaded) {
+    load_formula();
   }
 
-  // Get the first solution of the formula
-  const bool is_sat = solver.solve();
+  // Forget the result of the previous query
+  reset_state();
+  assumptions.copyTo(fixed_assumptions);
+
+  // Get the first solution of the formula under the assumptions
+  const bool is_sat = solver.solve(fixed_assumptions);
 
   if (!is_sat) {
     // Finish if the formula is unsatisfiable
     return false;
   }
 
+  notify_model(solver.model);
+
   // Initialize the candidates set with the literals of the first solution
   const vec<lbool>& solution = solver.model;
 
@@ -53,55 +52,104 @@ bool CheckCandidatesOneByOne::initialize() {
     if (value != l_Undef) {
       const Lit l = mkLit(variable, value == l_False);
       candidates.add(l);
+      // Candidates keep their detector activity and polarity until discarded
+      solver.mark_candidate(variable);
+      solver.set_detector_polarity(variable, sign(l) ? l_False : l_True);
     }
   }
 
+  // Accept what unit propagation already proves, without any SAT call
+  confirm_propagated();
+
+  // Drop the candidates that the first model already refutes once rotated
+  if (model_rotation) rotate_model(discarded_candidates);
+
   // The formula is satisfiable. Let's go for the backbone!
   return true;
 }
 
+void CheckCandidatesOneByOne::load_formula() {
+  solver.set_detector_weight(attention_weight);
+  for (Var i = 0; i <= max_id; ++i) {
+    solver.newVar();
+  }
+  vec<Lit> ls;
+  for (auto ci = clauses.begin(); ci != clauses.end(); ++ci) {
+    ls.clear();
+    for (auto li = (*ci).begin(); li != (*ci).end(); ++li) {
+      const Lit l = *li;
+      assert(var(l) <= max_id);
+      ls.push(l);
+    }
+    solver.addClause(ls);
+  }
+  loaded = true;
+}
+
 // Run of the worker
 void CheckCandidatesOneByOne::run() {
+  start_budget(solver);
   while (candidates.size()) {
     ++candidates_iterator;
     const Lit candidate = *candidates_iterator;
     vec<Lit> assumptions(1);
     assumptions[0] = ~candidate;
-    const bool is_sat = bump_and_solve(assumptions);
-    if (!is_sat) {
+    const lbool result = bump_and_solve(assumptions);
+    if (result == l_Undef) {
+      // Out of budget: the remaining candidates stay unknown
+      stop_on_budget();
+      break;
+    }
+    if (result == l_False) {
       backbone.add(candidate);
       discard_one_candidate();
+      // The clauses learnt by the refutation may let the assumptions
+      // propagate more candidates than they did in initialize()
+      if (fixed_assumptions.size() &&
+          solver.implies(fixed_assumptions, propagated)) {
+        confirm(propagated);
+      }
+      // Units are learnt by refutations; checking after models too would
+      // reorder the candidates that steer the next models
+      confirm_fixed();
     } else {
       discard_candidates();
     }
   }
 }
 
-bool CheckCandidatesOneByOne::bump_and_solve(const vec<Lit>& assumptions) {
-  // Update the solver's detector activities and polarities
-  for (auto li = candidates.begin(); li != candidates.end(); ++li) {
-    const Lit l = *li;
-    const Var v = var(l);
-    solver.bump(v);
-    solver.set_detector_polarity(v, sign(l) ? l_False : l_True);
+lbool CheckCandidatesOneByOne::bump_and_solve(const vec<Lit>& assumptions) {
+  // Raise the detector activity of all remaining candidates
+  solver.bump();
+  // The fixed assumptions of the current query always go first
+  fixed_assumptions.copyTo(query);
+  for (int i = 0; i < assumptions.size(); ++i) {
+    query.push(assumptions[i]);
+  }
+  const lbool result = solver.solveLimited(query);
+  if (result == l_True) {
+    notify_model(solver.model);
   }
-  return solver.solve(assumptions);
+  return result;
 }
 
 void CheckCandidatesOneByOne::discard_one_candidate() {
-  candidates.remove(*candidates_iterator);
-  const Var v = var(*candidates_iterator);
+  const Lit candidate = *candidates_iterator;
+  candidates.remove(candidate);
+  const Var v = var(candidate);
   solver.reset_activity_for_var(v);
   solver.reset_detector_polarity(v);
 }
 
 void CheckCandidatesOneByOne::discard_candidates() {
   candidates.discard_from_model(solver.model, max_id, discarded_candidates);
+  stats.eliminated_by_models += discarded_candidates.size();
   for (int i = 0; i < discarded_candidates.size(); ++i) {
     const Var v = var(discarded_candidates[i]);
     solver.reset_activity_for_var(v);
     solver.reset_detector_polarity(v);
   }
+  if (model_rotation) rotate_model(discarded_candidates);
 }
 
 // Getters
@@ -116,4 +164,11 @@ bool CheckCandidatesOneByOne::is_backbone(Var var) const {
 bool CheckCandidatesOneByOne::backbone_sign(Var var) const {
   assert(is_backbone(var));
   return is_backbone(mkLit(var));
-}
\ No newline at end of file
+}
+
+DetectorStats CheckCandidatesOneByOne::get_stats() const {
+  DetectorStats result = stats;
+  result.solves = solver.solves;
+  result.conflicts = solver.conflicts;
+  return result;
+}
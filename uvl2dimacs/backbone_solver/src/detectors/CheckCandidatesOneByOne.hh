@@ -69,6 +69,19 @@ class CheckCandidatesOneByOne : public BackBone {
    */
   virtual bool initialize() override;
 
+  /**
+   * @brief Initialize detector under assumptions and check satisfiability
+   *
+   * Loads the formula into the solver on the first call only. The assumptions
+   * are passed to every SAT call of the following run(), so the solver and
+   * its learnt clauses are reused across queries.
+   *
+   * @param assumptions Literals assumed to be true for this query
+   * @return true if formula is satisfiable under the assumptions
+   * @return false otherwise
+   */
+  virtual bool initialize(const vec<Lit>& assumptions) override;
+
   /**
    * @brief Run the backbone detection algorithm
    *
@@ -104,22 +117,21 @@ class CheckCandidatesOneByOne : public BackBone {
    */
   virtual bool backbone_sign(Var var) const override;
 
- private:
+  /**
+   * @brief Get the work counters, including those of the SAT solver
+   */
+  virtual DetectorStats get_stats() const override;
+
+ protected:
+  // Shared with CheckCandidatesInChunks, which only replaces run()
+
   // Formula data
-  const Var max_id;        ///< Maximum variable ID
-  const CNF& clauses;      ///< CNF formula to analyze
   const double attention_weight;  ///< Weight for detector activity
+  bool loaded;                    ///< Whether the formula is in the solver
 
   // Algorithm state
-  LiteralSet candidates;              ///< Literals that might be backbones
-  LiteralSet backbone;                ///< Confirmed backbone literals
   vec<Lit> discarded_candidates;      ///< Recently discarded candidates
-
-  // SAT solver
-  MiniSatExt solver;  ///< Extended MiniSat solver with activity bumping
-
-  // Iteration state
-  const_infinite_LiteralSetIterator candidates_iterator;  ///< Cycles through candidates
+  vec<Lit> query;                     ///< Assumptions passed to the solver
 
   /**
    * @brief Bump candidate activities and solve with assumptions
@@ -128,15 +140,16 @@ class CheckCandidatesOneByOne : public BackBone {
    * the solver to try flipping them, then solves with given assumptions.
    *
    * @param assumptions Literals to assume during solving
-   * @return true if satisfiable under assumptions
-   * @return false if unsatisfiable
+   * @return l_True if satisfiable under assumptions
+   * @return l_False if unsatisfiable
+   * @return l_Undef if the conflict budget ran out
    */
-  bool bump_and_solve(const vec<Lit>& assumptions);
+  lbool bump_and_solve(const vec<Lit>& assumptions);
 
   /**
-   * @brief Try to discard a single candidate by finding alternative assignment
+   * @brief Create the solver variables and add the formula clauses
    */
-  void discard_one_candidate();
+  void load_formula();
 
   /**
    * @brief Discard all candidates contradicted by current solver model
@@ -145,6 +158,12 @@ class CheckCandidatesOneByOne : public BackBone {
    * all candidates that have different values in the new solution.
    */
   void discard_candidates();
+
+ private:
+  /**
+   * @brief Try to discard a single candidate by finding alternative assignment
+   */
+  void discard_one_candidate();
 };
 
 }  // end of namespace bonedigger
@@ -66,6 +66,12 @@ bool FlatlandTester::is_flatland(double current_value) {
   return consecutive_stable_count >= required_consecutive_checks;
 }
 
+void FlatlandTester::reset() {
+  previous_value = 0.0;
+  consecutive_stable_count = 0;
+  initialized = false;
+}
+
 // ============================================================================
 // FastOnCliffsSlowOnPlains Implementation
 // ============================================================================
@@ -74,38 +80,38 @@ bool FlatlandTester::is_flatland(double current_value) {
 FastOnCliffsSlowOnPlains::FastOnCliffsSlowOnPlains(Var _max_id,
                                                    const CNF& _clauses,
                                                    double _attention_weight)
-    : max_id(_max_id),
-      clauses(_clauses),
+    : BackBone(_max_id, _clauses),
       attention_weight(_attention_weight),
-      candidates_iterator(candidates.infinite_iterator()) {}
+      loaded(false) {}
 
 FastOnCliffsSlowOnPlains::~FastOnCliffsSlowOnPlains() {}
 
 bool FastOnCliffsSlowOnPlains::initialize() {
-  // Initialize the solver
-  solver.set_detector_weight(attention_weight);
-  for (Var i = 0; i <= max_id; ++i) {
-    solver.newVar();
-  }
-  vec<Lit> ls;
-  for (auto ci = clauses.begin(); ci != clauses.end(); ++ci) {
-    ls.clear();
-    for (auto li = (*ci).begin(); li != (*ci).end(); ++li) {
-      const Lit l = *li;
-      assert(var(l) <= max_id);
-      ls.push(l);
-    }
-    solver.addClause(ls);
+  const vec<Lit> assumptions;
+  return initialize(assumptions);
+}
+
+bool FastOnCliffsSlowOnPlains::initialize(const vec<Lit>& assumptions) {
+  // Load the formula the first time; later calls reuse the solver
+  if (!loaded) {
+    load_formula();
   }
 
-  // Get the first solution of the formula
-  const bool is_sat = solver.solve();
+  // Forget the result of the previous query
+  reset_state();
+  flatland_tester.reset();
+  assumptions.copyTo(fixed_assumptions);
+
+  // Get the first solution of the formula under the assumptions
+  const bool is_sat = solver.solve(fixed_assumptions);
 
   if (!is_sat) {
     // Finish if the formula is unsatisfiable
     return false;
   }
 
+  notify_model(solver.model);
+
   // Initialize the candidates set with the literals of the first solution
   const vec<lbool>& solution = solver.model;
 
@@ -114,13 +120,40 @@ bool FastOnCliffsSlowOnPlains::initialize() {
     if (value != l_Undef) {
       const Lit l = mkLit(variable, value == l_False);
       candidates.add(l);
+      // Candidates keep their detector activity and polarity until discarded
+      solver.mark_candidate(variable);
+      solver.set_detector_polarity(variable, sign(l) ? l_False : l_True);
     }
   }
 
+  // Accept what unit propagation already proves, without any SAT call
+  confirm_propagated();
+
+  // Drop the candidates that the first model already refutes once rotated
+  if (model_rotation) rotate_model(discarded_candidates);
+
   // The formula is satisfiable. Let's go for the backbone!
   return true;
 }
 
+void FastOnCliffsSlowOnPlains::load_formula() {
+  solver.set_detector_weight(attention_weight);
+  for (Var i = 0; i <= max_id; ++i) {
+    solver.newVar();
+  }
+  vec<Lit> ls;
+  for (auto ci = clauses.begin(); ci != clauses.end(); ++ci) {
+    ls.clear();
+    for (auto li = (*ci).begin(); li != (*ci).end(); ++li) {
+      const Lit l = *li;
+      assert(var(l) <= max_id);
+      ls.push(l);
+    }
+    solver.addClause(ls);
+  }
+  loaded = true;
+}
+
 // Run of the worker
 void FastOnCliffsSlowOnPlains::run() {
   int number_of_previous_candidates;
@@ -129,24 +162,30 @@ void FastOnCliffsSlowOnPlains::run() {
   vec<Lit> literals;
   Lit relaxation_literal = lit_Undef;
 
+  start_budget(solver);
   while (candidates.size()) {
     // Store the number of candidates before discarding
     number_of_previous_candidates = (int)candidates.size();
     // Rush down the ravine!
     if (!is_flatland) {
-      bump_and_solve();
+      if (bump_and_solve() == l_Undef) {
+        stop_on_budget();
+        break;
+      }
       discard_candidates();
       // Move carefully on the plateau
     } else {
-      // Relax the clause added in the previous iteration
+      // Relax the clause added in the previous iteration. Releasing the
+      // literal satisfies the clause, which the solver deletes at its next
+      // simplification, and hands the variable back to newVar()
       if (relaxation_literal != lit_Undef) {
-        solver.addClause(relaxation_literal);
+        solver.releaseVar(relaxation_literal);
       }
 
       literals.clear();
 
       // Create a new relaxation literal
-      const Lit relaxation_literal = mkLit(solver.newVar());
+      relaxation_literal = mkLit(solver.newVar());
       literals.push(relaxation_literal);
 
       // Create the clause ~lit1 or ~lit2 or ... for all candidates
@@ -164,11 +203,18 @@ void FastOnCliffsSlowOnPlains::run() {
       // relaxation_literal is false)
       vec<Lit> assumptions(1);
       assumptions[0] = ~relaxation_literal;
-      const bool is_sat = bump_and_solve(assumptions);
+      const lbool result = bump_and_solve(assumptions);
 
       // Analyze solver's output
-      if (!is_sat) {
-        backbone = candidates;
+      if (result == l_Undef) {
+        // Out of budget: the remaining candidates stay unknown
+        stop_on_budget();
+        break;
+      } else if (result == l_False) {
+        // The remaining candidates join the confirmed ones
+        for (auto li = candidates.begin(); li != candidates.end(); ++li) {
+          backbone.add(*li);
+        }
         break;
       } else {
         discard_candidates();
@@ -177,36 +223,48 @@ void FastOnCliffsSlowOnPlains::run() {
 
     // Update the number of candidates after discarding
     number_of_current_candidates = (int)candidates.size();
+    confirm_fixed();
 
     // Check if we are in a flatland
     is_flatland = flatland_tester.is_flatland(number_of_previous_candidates -
                                               number_of_current_candidates);
   }
+
+  // Relax the last clause so the solver can be reused for the next query
+  if (relaxation_literal != lit_Undef) {
+    solver.releaseVar(relaxation_literal);
+  }
 }
 
-bool FastOnCliffsSlowOnPlains::bump_and_solve(const vec<Lit>& assumptions) {
-  // Update the solver's detector activities and polarities
-  for (auto li = candidates.begin(); li != candidates.end(); ++li) {
-    const Lit l = *li;
-    const Var v = var(l);
-    solver.bump(v);
-    solver.set_detector_polarity(v, sign(l) ? l_False : l_True);
+lbool FastOnCliffsSlowOnPlains::bump_and_solve(const vec<Lit>& assumptions) {
+  // Raise the detector activity of all remaining candidates
+  solver.bump();
+  // The fixed assumptions of the current query always go first
+  fixed_assumptions.copyTo(query);
+  for (int i = 0; i < assumptions.size(); ++i) {
+    query.push(assumptions[i]);
+  }
+  const lbool result = solver.solveLimited(query);
+  if (result == l_True) {
+    notify_model(solver.model);
   }
-  return solver.solve(assumptions);
+  return result;
 }
 
-bool FastOnCliffsSlowOnPlains::bump_and_solve() {
+lbool FastOnCliffsSlowOnPlains::bump_and_solve() {
   const vec<Lit> assumptions;
   return bump_and_solve(assumptions);
 }
 
 void FastOnCliffsSlowOnPlains::discard_candidates() {
   candidates.discard_from_model(solver.model, max_id, discarded_candidates);
+  stats.eliminated_by_models += discarded_candidates.size();
   for (int i = 0; i < discarded_candidates.size(); ++i) {
     const Var v = var(discarded_candidates[i]);
     solver.reset_activity_for_var(v);
     solver.reset_detector_polarity(v);
   }
+  if (model_rotation) rotate_model(discarded_candidates);
 }
 
 // Getters
@@ -222,3 +280,10 @@ bool FastOnCliffsSlowOnPlains::backbone_sign(Var var) const {
   assert(is_backbone(var));
   return is_backbone(mkLit(var));
 }
+
+DetectorStats FastOnCliffsSlowOnPlains::get_stats() const {
+  DetectorStats result = stats;
+  result.solves = solver.solves;
+  result.conflicts = solver.conflicts;
+  return result;
+}
@@ -12,38 +12,37 @@ using Minisat::lit_Undef;
 // Initialization
 RushAndPray::RushAndPray(Var _max_id, const CNF& _clauses,
                          double _attention_weight)
-    : max_id(_max_id),
-      clauses(_clauses),
+    : BackBone(_max_id, _clauses),
       attention_weight(_attention_weight),
-      candidates_iterator(candidates.infinite_iterator()) {}
+      loaded(false) {}
 
 RushAndPray::~RushAndPray() {}
 
 bool RushAndPray::initialize() {
-  // Initialize the solver
-  solver.set_detector_weight(attention_weight);
-  for (Var i = 0; i <= max_id; ++i) {
-    solver.newVar();
-  }
-  vec<Lit> ls;
-  for (auto ci = clauses.begin(); ci != clauses.end(); ++ci) {
-    ls.clear();
-    for (auto li = (*ci).begin(); li != (*ci).end(); ++li) {
-      const Lit l = *li;
-      assert(var(l) <= max_id);
-      ls.push(l);
-    }
-    solver.addClause(ls);
+  const vec<Lit> assumptions;
+  return initialize(assumptions);
+}
+
+bool RushAndPray::initialize(const vec<Lit>& assumptions) {
+  // Load the formula the first time; later calls reuse the solver
+  if (!loaded) {
+    load_formula();
   }
 
-  // Get the first solution of the formula
-  const bool is_sat = solver.solve();
+  // Forget the result of the previous query
+  reset_state();
+  assumptions.copyTo(fixed_assumptions);
+
+  // Get the first solution of the formula under the assumptions
+  const bool is_sat = solver.solve(fixed_assumptions);
 
   if (!is_sat) {
     // Finish if the formula is unsatisfiable
     return false;
   }
 
+  notify_model(solver.model);
+
   // Initialize the candidates set with the literals of the first solution
   const vec<lbool>& solution = solver.model;
 
@@ -52,26 +51,58 @@ bool RushAndPray::initialize() {
     if (value != l_Undef) {
       const Lit l = mkLit(variable, value == l_False);
       candidates.add(l);
+      // Candidates keep their detector activity and polarity until discarded
+      solver.mark_candidate(variable);
+      solver.set_detector_polarity(variable, sign(l) ? l_False : l_True);
     }
   }
 
+  // Accept what unit propagation already proves, without any SAT call
+  confirm_propagated();
+
+  // Drop the candidates that the first model already refutes once rotated
+  if (model_rotation) rotate_model(discarded_candidates);
+
   // The formula is satisfiable. Let's go for the backbone!
   return true;
 }
 
+void RushAndPray::load_formula() {
+  solver.set_detector_weight(attention_weight);
+  for (Var i = 0; i <= max_id; ++i) {
+    solver.newVar();
+  }
+  vec<Lit> ls;
+  for (auto ci = clauses.begin(); ci != clauses.end(); ++ci) {
+    ls.clear();
+    for (auto li = (*ci).begin(); li != (*ci).end(); ++li) {
+      const Lit l = *li;
+      assert(var(l) <= max_id);
+      ls.push(l);
+    }
+    solver.addClause(ls);
+  }
+  loaded = true;
+}
+
 // Run of the worker
 void RushAndPray::run() {
   int number_of_previous_candidates;
   int number_of_current_candidates;
+  start_budget(solver);
   do {
     number_of_previous_candidates = (int)candidates.size();
 
     // Early termination if no candidates left
     if (number_of_previous_candidates == 0) break;
 
-    bump_and_solve();
+    if (bump_and_solve() == l_Undef) {
+      stop_on_budget();
+      return;
+    }
     discard_candidates();
     number_of_current_candidates = (int)candidates.size();
+    confirm_fixed();
   } while (number_of_previous_candidates != number_of_current_candidates);
 
   // Only verify if we still have candidates
@@ -80,29 +111,35 @@ void RushAndPray::run() {
   }
 }
 
-bool RushAndPray::bump_and_solve(const vec<Lit>& assumptions) {
-  // Update the solver's detector activities and polarities
-  for (auto li = candidates.begin(); li != candidates.end(); ++li) {
-    const Lit l = *li;
-    const Var v = var(l);
-    solver.bump(v);
-    solver.set_detector_polarity(v, sign(l) ? l_False : l_True);
+lbool RushAndPray::bump_and_solve(const vec<Lit>& assumptions) {
+  // Raise the detector activity of all remaining candidates
+  solver.bump();
+  // The fixed assumptions of the current query always go first
+  fixed_assumptions.copyTo(query);
+  for (int i = 0; i < assumptions.size(); ++i) {
+    query.push(assumptions[i]);
+  }
+  const lbool result = solver.solveLimited(query);
+  if (result == l_True) {
+    notify_model(solver.model);
   }
-  return solver.solve(assumptions);
+  return result;
 }
 
-bool RushAndPray::bump_and_solve() {
+lbool RushAndPray::bump_and_solve() {
   const vec<Lit> assumptions;
   return bump_and_solve(assumptions);
 }
 
 void RushAndPray::discard_candidates() {
   candidates.discard_from_model(solver.model, max_id, discarded_candidates);
+  stats.eliminated_by_models += discarded_candidates.size();
   for (int i = 0; i < discarded_candidates.size(); ++i) {
     const Var v = var(discarded_candidates[i]);
     solver.reset_activity_for_var(v);
     solver.reset_detector_polarity(v);
   }
+  if (model_rotation) rotate_model(discarded_candidates);
 }
 
 void RushAndPray::verify_candidates() {
@@ -111,14 +148,16 @@ void RushAndPray::verify_candidates() {
   Lit relaxation_literal = lit_Undef;
 
   while (candidates.size()) {
-    // Relax the clause added in the previous iteration
+    // Relax the clause added in the previous iteration. Releasing the
+    // literal satisfies the clause, which the solver deletes at its next
+    // simplification, and hands the variable back to newVar()
     if (relaxation_literal != lit_Undef) {
-      solver.addClause(relaxation_literal);
+      solver.releaseVar(relaxation_literal);
     }
 
     literals.clear();
     // Create a new relaxation literal
-    const Lit relaxation_literal = mkLit(solver.newVar());
+    relaxation_literal = mkLit(solver.newVar());
     literals.push(relaxation_literal);
 
     // Create the clause ~lit1 or ~lit2 or ... for all candidates
@@ -135,16 +174,29 @@ void RushAndPray::verify_candidates() {
     // Run the solver enabling the clause (assuming that the relaxation_literal
     // is false)
     assumptions[0] = ~relaxation_literal;
-    const bool is_sat = bump_and_solve(assumptions);
+    const lbool result = bump_and_solve(assumptions);
 
     // Analyze solver's output
-    if (!is_sat) {
-      backbone = candidates;
+    if (result == l_Undef) {
+      // Out of budget: the remaining candidates stay unknown
+      stop_on_budget();
+      break;
+    } else if (result == l_False) {
+      // The remaining candidates join the confirmed ones
+      for (auto li = candidates.begin(); li != candidates.end(); ++li) {
+        backbone.add(*li);
+      }
       break;
     } else {
       discard_candidates();
+      confirm_fixed();
     }
   }
+
+  // Relax the last clause so the solver can be reused for the next query
+  if (relaxation_literal != lit_Undef) {
+    solver.releaseVar(relaxation_literal);
+  }
 }
 
 // Getters
@@ -160,3 +212,10 @@ bool RushAndPray::backbone_sign(Var var) const {
   assert(is_backbone(var));
   return is_backbone(mkLit(var));
 }
+
+DetectorStats RushAndPray::get_stats() const {
+  DetectorStats result = stats;
+  result.solves = solver.solves;
+  result.conflicts = solver.conflicts;
+  return result;
+}
@@ -65,6 +65,16 @@ class RushAndPray : public BackBone {
    */
   virtual bool initialize() override;
 
+  /**
+   * @brief Initialize under assumptions and check satisfiability
+   *
+   * The formula is loaded into the solver on the first call only.
+   *
+   * @param assumptions Literals assumed to be true for this query
+   * @return true if satisfiable under the assumptions
+   */
+  virtual bool initialize(const vec<Lit>& assumptions) override;
+
   /**
    * @brief Run rush-and-verify backbone detection
    *
@@ -94,28 +104,34 @@ class RushAndPray : public BackBone {
    */
   virtual bool backbone_sign(Var var) const override;
 
+  /**
+   * @brief Get the work counters, including those of the SAT solver
+   */
+  virtual DetectorStats get_stats() const override;
+
  private:
-  const Var max_id;                   ///< Maximum variable ID
-  const CNF& clauses;                 ///< CNF formula
   const double attention_weight;      ///< Weight for detector activity
-  LiteralSet candidates;              ///< Candidate backbone literals
-  LiteralSet backbone;                ///< Confirmed backbone literals
+  bool loaded;                        ///< Whether the formula is in the solver
   vec<Lit> discarded_candidates;      ///< Recently discarded candidates
-  MiniSatExt solver;                  ///< SAT solver
-  const_infinite_LiteralSetIterator candidates_iterator;  ///< Iterates through candidates
+  vec<Lit> query;                     ///< Assumptions passed to the solver
 
   /**
    * @brief Bump activities and solve with assumptions
    * @param assumptions Literals to assume
-   * @return true if satisfiable
+   * @return l_True if satisfiable, l_False if not, l_Undef if out of budget
    */
-  bool bump_and_solve(const vec<Lit>& assumptions);
+  lbool bump_and_solve(const vec<Lit>& assumptions);
 
   /**
    * @brief Bump activities and solve without assumptions
-   * @return true if satisfiable
+   * @return l_True if satisfiable, l_Undef if out of budget
+   */
+  lbool bump_and_solve();
+
+  /**
+   * @brief Create the solver variables and add the formula clauses
    */
-  bool bump_and_solve();
+  void load_formula();
 
   /**
    * @brief Discard candidates contradicted by current model
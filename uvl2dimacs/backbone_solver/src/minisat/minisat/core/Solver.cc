@@ -84,9 +84,12 @@ Solver::Solver() :
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0)
   , dec_vars(0), num_clauses(0), num_learnts(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
 
+  , detector_vars      (0)
+  , detector_activity  (0)
   , detector_weight    (1.0)
   , watches            (WatcherDeleted(ca))
-  , order_heap         (VarOrderLt(activity, detector_activity, detector_weight))
+  , order_heap         (VarOrderLt(activity))
+  , detector_heap      (VarOrderLt(activity))
   , ok                 (true)
   , cla_inc            (1)
   , var_inc            (1)
@@ -131,7 +134,7 @@ Var Solver::newVar(lbool upol, bool dvar)
     assigns  .insert(v, l_Undef);
     vardata  .insert(v, mkVarData(CRef_Undef, 0));
     activity .insert(v, rnd_init_act ? drand(random_seed) * 0.00001 : 0);
-    detector_activity.insert(v, 0);
+    detector_var.insert(v, 0);
     seen     .insert(v, 0);
     polarity .insert(v, true);
     user_pol .insert(v, upol);
@@ -263,18 +266,20 @@ Lit Solver::pickBranchLit()
     Var next = var_Undef;
 
     // Random decision:
-    if (drand(random_seed) < random_var_freq && !order_heap.empty()){
-        next = order_heap[irand(random_seed,order_heap.size())];
+    const int heap_size = order_heap.size() + detector_heap.size();
+    if (drand(random_seed) < random_var_freq && heap_size > 0){
+        const int i = irand(random_seed, heap_size);
+        next = i < order_heap.size() ? order_heap[i] : detector_heap[i - order_heap.size()];
         if (value(next) == l_Undef && decision[next])
             rnd_decisions++; }
 
-    // Activity based decision:
+    // Activity based decision (marked variables add the weighted detector activity):
     while (next == var_Undef || value(next) != l_Undef || !decision[next])
-        if (order_heap.empty()){
+        if (order_heap.empty() && detector_heap.empty()){
             next = var_Undef;
             break;
         }else
-            next = order_heap.removeMin();
+            next = detectorHeapFirst() ? detector_heap.removeMin() : order_heap.removeMin();
 
     // Choose polarity based on different polarity modes (global or per-variable):
     // Detector polarity only applies when detector_weight > 0
@@ -637,11 +642,12 @@ void Solver::removeSatisfied(vec<CRef>& cs)
 
 void Solver::rebuildOrderHeap()
 {
-    vec<Var> vs;
+    vec<Var> vs, ds;
     for (Var v = 0; v < nVars(); v++)
         if (decision[v] && value(v) == l_Undef)
-            vs.push(v);
+            (detector_var[v] ? ds : vs).push(v);
     order_heap.build(vs);
+    detector_heap.build(ds);
 }
 
 
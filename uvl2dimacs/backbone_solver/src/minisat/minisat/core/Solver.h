@@ -21,6 +21,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef Minisat_Solver_h
 #define Minisat_Solver_h
 
+#include <atomic>
+
 #include "minisat/mtl/Vec.h"
 #include "minisat/mtl/Heap.h"
 #include "minisat/mtl/Alg.h"
@@ -175,16 +177,8 @@ protected:
 
     struct VarOrderLt {
         const IntMap<Var, double>&  activity;
-        const IntMap<Var, double>&  detector_activity;
-        const double&              detector_weight;
-        bool operator () (Var x, Var y) const {
-            return (activity[x] + detector_weight * detector_activity[x]) >
-                   (activity[y] + detector_weight * detector_activity[y]);
-        }
-        VarOrderLt(const IntMap<Var, double>& act,
-                   const IntMap<Var, double>& det_act,
-                   const double& det_w)
-            : activity(act), detector_activity(det_act), detector_weight(det_w) {}
+        bool operator () (Var x, Var y) const { return activity[x] > activity[y]; }
+        VarOrderLt(const IntMap<Var, double>&  act) : activity(act) { }
     };
 
     struct ShrinkStackElem {
@@ -202,7 +196,9 @@ protected:
     vec<Lit>            assumptions;      // Current set of assumptions provided to solve by the user.
 
     VMap<double>        activity;         // A heuristic measurement of the activity of a variable.
-    VMap<double>        detector_activity; // Activity set by backbone detectors (separate from VSIDS).
+    VMap<char>          detector_var;     // Variables marked by backbone detectors; they share 'detector_activity'.
+    int                 detector_vars;    // Number of marked variables.
+    double              detector_activity; // Activity of every marked variable (separate from VSIDS).
     double              detector_weight;  // Weight for combining detector_activity with VSIDS activity.
     VMap<lbool>         assigns;          // The current assignments.
     VMap<char>          polarity;         // The preferred polarity of each variable.
@@ -213,7 +209,8 @@ protected:
     OccLists<Lit, vec<Watcher>, WatcherDeleted, MkIndexLit>
                         watches;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
 
-    Heap<Var,VarOrderLt>order_heap;       // A priority queue of variables ordered with respect to the variable activity.
+    Heap<Var,VarOrderLt>order_heap;       // A priority queue of unmarked variables ordered with respect to the variable activity.
+    Heap<Var,VarOrderLt>detector_heap;    // The same for the marked variables (their common detector activity does not change the order).
 
     bool                ok;               // If FALSE, the constraints are already unsatisfiable. No part of the solver state may be used!
     double              cla_inc;          // Amount to bump next clause with.
@@ -245,7 +242,7 @@ protected:
     //
     int64_t             conflict_budget;    // -1 means no budget.
     int64_t             propagation_budget; // -1 means no budget.
-    bool                asynch_interrupt;
+    std::atomic<bool>   asynch_interrupt;   // Set by interrupt(), possibly from another thread.
 
     // Main internal methods:
     //
@@ -270,9 +267,9 @@ protected:
     void     varDecayActivity ();                      // Decay all variables with the specified factor. Implemented by increasing the 'bump' value instead.
     void     varBumpActivity  (Var v, double inc);     // Increase a variable with the current 'bump' value.
     void     varBumpActivity  (Var v);                 // Increase a variable with the current 'bump' value.
-    void     detectorBumpActivity(Var v, double inc);  // Bump detector activity for a variable.
-    void     detectorBumpActivity(Var v);              // Bump detector activity with current var_inc.
-    void     resetDetectorActivity(Var v);             // Reset detector activity to 0.
+    void     detectorBumpActivity();                   // Bump the detector activity of all marked variables with current var_inc.
+    void     setDetectorVar   (Var v, bool b);         // Mark or unmark a variable (unmarked variables have no detector activity).
+    bool     detectorHeapFirst() const;                // Is the most active variable in 'detector_heap'?
     void     setDetectorPolarity(Var v, lbool b);      // Set detector polarity for a variable.
     void     setDetectorWeight(double w);              // Set the detector activity weight.
     void     claDecayActivity ();                      // Decay all clauses with the specified factor. Implemented by increasing the 'bump' value instead.
@@ -320,39 +317,48 @@ inline CRef Solver::reason(Var x) const { return vardata[x].reason; }
 inline int  Solver::level (Var x) const { return vardata[x].level; }
 
 inline void Solver::insertVarOrder(Var x) {
-    if (!order_heap.inHeap(x) && decision[x]) order_heap.insert(x); }
+    Heap<Var,VarOrderLt>& heap = detector_var[x] ? detector_heap : order_heap;
+    if (!heap.inHeap(x) && decision[x]) heap.insert(x); }
 
 inline void Solver::varDecayActivity() { var_inc *= (1 / var_decay); }
 inline void Solver::varBumpActivity(Var v) { varBumpActivity(v, var_inc); }
 inline void Solver::varBumpActivity(Var v, double inc) {
     if ( (activity[v] += inc) > 1e100 ) {
         // Rescale:
-        for (int i = 0; i < nVars(); i++) {
+        for (int i = 0; i < nVars(); i++)
             activity[i] *= 1e-100;
-            detector_activity[i] *= 1e-100;
-        }
+        detector_activity *= 1e-100;
         var_inc *= 1e-100; }
 
     // Update order_heap with respect to new activity:
     if (order_heap.inHeap(v))
-        order_heap.decrease(v); }
+        order_heap.decrease(v);
+    else if (detector_heap.inHeap(v))
+        detector_heap.decrease(v); }
 
-inline void Solver::detectorBumpActivity(Var v) { detectorBumpActivity(v, var_inc); }
-inline void Solver::detectorBumpActivity(Var v, double inc) {
-    if ( (detector_activity[v] += inc) > 1e100 ) {
+inline void Solver::detectorBumpActivity() {
+    if ( (detector_activity += var_inc) > 1e100 ) {
         // Rescale:
         for (int i = 0; i < nVars(); i++)
-            detector_activity[i] *= 1e-100;
-    }
-
-    // Update order_heap with respect to new combined activity:
-    if (order_heap.inHeap(v))
-        order_heap.decrease(v); }
-
-inline void Solver::resetDetectorActivity(Var v) {
-    detector_activity[v] = 0.0;
-    if (order_heap.inHeap(v))
-        order_heap.increase(v); }
+            activity[i] *= 1e-100;
+        detector_activity *= 1e-100;
+        var_inc *= 1e-100; } }
+
+inline void Solver::setDetectorVar(Var v, bool b) {
+    if ((detector_var[v] != 0) == b) return;
+    Heap<Var,VarOrderLt>& heap = b ? order_heap : detector_heap;
+    const bool in_heap = heap.inHeap(v);
+    if (in_heap) heap.remove(v);
+    detector_var[v] = b;
+    detector_vars += b ? 1 : -1;
+    // Variables marked later start again from zero:
+    if (detector_vars == 0) detector_activity = 0;
+    if (in_heap) insertVarOrder(v); }
+
+inline bool Solver::detectorHeapFirst() const {
+    if (detector_heap.empty()) return false;
+    if (order_heap.empty()) return true;
+    return activity[detector_heap[0]] + detector_weight * detector_activity > activity[order_heap[0]]; }
 
 inline void Solver::setDetectorPolarity(Var v, lbool b) { detector_pol[v] = b; }
 inline void Solver::setDetectorWeight(double w) { detector_weight = w; }
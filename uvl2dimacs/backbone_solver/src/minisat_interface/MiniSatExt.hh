@@ -28,28 +28,40 @@ namespace Minisat {
 class MiniSatExt : public Solver {
  public:
   /**
-   * @brief Bump the detector activity of a variable
+   * @brief Mark a variable as a backbone candidate
    *
-   * Increases the detector's activity score for a variable,
-   * making it more likely to be selected for branching. This is used
+   * Marked variables share one detector activity, raised by bump(). A
+   * variable is marked once, when its literal becomes a candidate, and
+   * unmarked with reset_activity_for_var() when it stops being one. When
+   * the last variable is unmarked the shared activity drops back to zero.
+   *
+   * @param v The variable to mark
+   */
+  inline void mark_candidate(Var v) { setDetectorVar(v, true); }
+
+  /**
+   * @brief Bump the detector activity of every marked variable
+   *
+   * Increases the detector's activity score of all candidates at once,
+   * making them more likely to be selected for branching. This is used
    * in backbone detection to guide the solver toward assignments that
-   * contradict candidate backbone literals.
+   * contradict candidate backbone literals. Costs O(1): the candidates
+   * sit in a heap of their own, whose order the common score does not
+   * change.
    *
    * The detector activity is kept separate from the VSIDS activity
    * and combined during variable ordering using the detector weight.
-   *
-   * @param var The variable whose detector activity should be increased
    */
-  inline void bump(const Var var) { detectorBumpActivity(var); }
+  inline void bump() { detectorBumpActivity(); }
 
   /**
    * @brief Reset the detector activity of a variable to zero
    *
-   * Sets the detector's activity score for a variable back to zero.
+   * Unmarks the variable, so its detector activity is zero from now on.
    *
    * @param v The variable whose detector activity should be reset
    */
-  inline void reset_activity_for_var(Var v) { resetDetectorActivity(v); }
+  inline void reset_activity_for_var(Var v) { setDetectorVar(v, false); }
 
   /**
    * @brief Set the weight for combining detector activity with VSIDS activity
@@ -81,6 +93,41 @@ class MiniSatExt : public Solver {
    * @param v The variable whose detector polarity should be reset
    */
   inline void reset_detector_polarity(Var v) { setDetectorPolarity(v, l_Undef); }
+
+  /**
+   * @brief Collect the literals fixed at decision level 0 since the last call
+   *
+   * Level-0 literals follow from the clauses alone (units given or learnt
+   * during search), so they hold in every model under any assumptions.
+   * The level-0 trail only grows, except when simplify() drops released
+   * variables from it. Variables up to max_var are never released, so the
+   * scan resumes after the last one reported, or starts over if that
+   * literal has moved.
+   *
+   * @param max_var Highest variable to report (higher ones, such as
+   *                relaxation variables, are skipped)
+   * @param out Output: the new level-0 literals, cleared first
+   */
+  void new_level0_literals(Var max_var, vec<Lit>& out) {
+    out.clear();
+    const int end = decisionLevel() == 0 ? trail.size() : trail_lim[0];
+    if (level0_last >= end ||
+        (level0_last >= 0 && trail[level0_last] != level0_last_lit)) {
+      level0_last = -1;
+    }
+    for (int i = level0_last + 1; i < end; ++i) {
+      const Var v = var(trail[i]);
+      if (v > 0 && v <= max_var) {
+        out.push(trail[i]);
+        level0_last = i;
+        level0_last_lit = trail[i];
+      }
+    }
+  }
+
+ private:
+  int level0_last = -1;             ///< Trail position of the last literal reported
+  Lit level0_last_lit = lit_Undef;  ///< The literal at that position
 };
 
 }  // namespace Minisat